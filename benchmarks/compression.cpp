@@ -0,0 +1,111 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Save the workbook with the given options a few times and report the
+// average time, the resulting file size and the save throughput measured
+// against the size of the file saved without compression.
+void save(const xlnt::workbook &wb, const xlnt::save_options &options, const std::string &name,
+    std::size_t stored_size)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto repeat = 3;
+    std::string data;
+
+    auto start = current_time();
+
+    for (auto i = 0; i < repeat; ++i)
+    {
+        std::ostringstream data_stream;
+        wb.save(data_stream, options);
+        data = data_stream.str();
+    }
+
+    const auto elapsed = (current_time() - start) / static_cast<double>(repeat);
+    const auto size = stored_size == 0 ? data.size() : stored_size;
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << data.size() << " bytes "
+              << std::setw(8) << std::fixed << std::setprecision(1) << elapsed << "ms " << std::setw(8)
+              << size / 1024.0 / 1024.0 / (elapsed / 1000.0) << " MiB/s" << std::endl;
+}
+
+std::size_t stored_size(const xlnt::workbook &wb)
+{
+    xlnt::save_options options;
+    options.compression_level = 0;
+    std::ostringstream data_stream;
+    wb.save(data_stream, options);
+
+    return data_stream.str().size();
+}
+
+} // namespace
+
+int main()
+{
+    xlnt::workbook wb;
+    wb.load(path_helper::benchmark_file("large.xlsx"));
+
+    const auto uncompressed = stored_size(wb);
+
+    for (auto level = 0; level <= 9; ++level)
+    {
+        xlnt::save_options options;
+        options.compression_level = level;
+        save(wb, options, "level " + std::to_string(level), uncompressed);
+    }
+
+    const auto strategies = std::vector<std::pair<xlnt::compression_strategy, std::string>>
+    {
+        {xlnt::compression_strategy::filtered, "filtered"},
+        {xlnt::compression_strategy::huffman_only, "huffman_only"},
+        {xlnt::compression_strategy::run_length, "run_length"},
+        {xlnt::compression_strategy::fixed, "fixed"}
+    };
+
+    for (const auto &strategy : strategies)
+    {
+        xlnt::save_options options;
+        options.strategy = strategy.first;
+        save(wb, options, strategy.second, uncompressed);
+    }
+
+    xlnt::save_options fast_worksheets;
+    fast_worksheets.part_compression_levels[xlnt::relationship_type::worksheet] = 1;
+    save(wb, fast_worksheets, "worksheets at level 1", uncompressed);
+
+    return 0;
+}
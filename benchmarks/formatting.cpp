@@ -0,0 +1,122 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Format a column of numbers with cell::to_string, which returns a new
+// string for each cell, and with the overload which reuses one buffer.
+void cells_to_string(int rows)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+    std::vector<xlnt::cell> cells;
+
+    for (int index = 0; index < rows; index++)
+    {
+        cells.push_back(ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1))));
+        cells.back().value(index * 1.25 + 0.001);
+    }
+
+    std::size_t length = 0;
+    auto start = current_time();
+
+    for (const auto &cell : cells)
+    {
+        length += cell.to_string().size();
+    }
+
+    auto returned = current_time() - start;
+
+    std::string buffer;
+    start = current_time();
+
+    for (const auto &cell : cells)
+    {
+        cell.to_string(buffer);
+        length += buffer.size();
+    }
+
+    auto buffered = current_time() - start;
+
+    std::cout << "cell::to_string " << rows << " cells: " << returned / 1000.0 << "s returned, "
+              << buffered / 1000.0 << "s buffered (" << length << " characters)" << std::endl;
+}
+
+// Format the same values with number formats that exports commonly use.
+void number_formats(int count)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto formats = std::vector<xlnt::number_format>{xlnt::number_format::number_00(),
+        xlnt::number_format::number_comma_separated1(), xlnt::number_format::date_yyyymmdd2()};
+
+    for (const auto &format : formats)
+    {
+        std::size_t length = 0;
+        auto start = current_time();
+
+        for (int index = 0; index < count; index++)
+        {
+            length += format.format(40000 + index * 0.37, xlnt::calendar::windows_1900).size();
+        }
+
+        auto returned = current_time() - start;
+
+        std::string buffer;
+        start = current_time();
+
+        for (int index = 0; index < count; index++)
+        {
+            format.format(40000 + index * 0.37, xlnt::calendar::windows_1900, buffer);
+            length += buffer.size();
+        }
+
+        auto buffered = current_time() - start;
+
+        std::cout << "\"" << format.format_string() << "\" " << count << " numbers: " << returned / 1000.0
+                  << "s returned, " << buffered / 1000.0 << "s buffered (" << length << " characters)" << std::endl;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    cells_to_string(100000);
+    cells_to_string(1000000);
+
+    number_formats(1000000);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Load the workbook held in data a few times and report the average time.
+void load(const std::string &name, const std::vector<std::uint8_t> &data)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto repeat = 5;
+    std::size_t cells = 0;
+
+    auto start = current_time();
+
+    for (auto i = 0; i < repeat; ++i)
+    {
+        xlnt::workbook wb;
+        wb.load(data);
+
+        for (auto ws : wb)
+        {
+            cells += ws.calculate_dimension().width() * ws.calculate_dimension().height();
+        }
+    }
+
+    const auto elapsed = (current_time() - start) / static_cast<double>(repeat);
+
+    std::cout << "load " << name << ": " << elapsed / 1000.0 << "s (" << cells / repeat
+              << " cells in dimension)" << std::endl;
+}
+
+// A worksheet of fractional numbers, which are parsed from each cell's <v> text.
+std::vector<std::uint8_t> numeric_workbook()
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (xlnt::row_t row = 1; row <= 100000; ++row)
+    {
+        for (xlnt::column_t::index_t column = 1; column <= 5; ++column)
+        {
+            ws.cell(column, row).value((row * 5 + column) / 8.0);
+        }
+    }
+
+    std::vector<std::uint8_t> data;
+    wb.save(data);
+
+    return data;
+}
+
+// Load the workbook held in data a few times, read one worksheet from the middle
+// of it and report the average time.
+void load_one_sheet(const std::string &name, const std::string &data, bool lazy)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto repeat = 5;
+    std::size_t cells = 0;
+
+    xlnt::load_options options;
+    options.lazy_worksheets = lazy;
+
+    auto start = current_time();
+
+    for (auto i = 0; i < repeat; ++i)
+    {
+        std::istringstream data_stream(data);
+
+        xlnt::workbook wb;
+        wb.load(data_stream, options);
+
+        auto ws = wb.sheet_by_index(wb.sheet_count() / 2);
+        cells += ws.calculate_dimension().width() * ws.calculate_dimension().height();
+    }
+
+    const auto elapsed = (current_time() - start) / static_cast<double>(repeat);
+
+    std::cout << "load one sheet of " << name << (lazy ? " lazily" : "") << ": " << elapsed / 1000.0
+              << "s (" << cells / repeat << " cells in dimension)" << std::endl;
+}
+
+// Many worksheets of numbers, of which load_one_sheet only needs one.
+std::string many_sheet_workbook()
+{
+    xlnt::workbook wb;
+
+    for (std::size_t sheet = 0; sheet < 200; ++sheet)
+    {
+        auto ws = sheet == 0 ? wb.active_sheet() : wb.create_sheet();
+
+        for (xlnt::row_t row = 1; row <= 1000; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 5; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * 5 + column));
+            }
+        }
+    }
+
+    std::ostringstream data;
+    wb.save(data);
+
+    return data.str();
+}
+
+} // namespace
+
+int main()
+{
+    std::ifstream file(path_helper::benchmark_file("large.xlsx").string(), std::ios::binary);
+    const auto large = std::vector<std::uint8_t>(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    load("large.xlsx", large);
+    load("numbers", numeric_workbook());
+
+    const auto many_sheets = many_sheet_workbook();
+    load_one_sheet("200 sheets", many_sheets, false);
+    load_one_sheet("200 sheets", many_sheets, true);
+
+    return 0;
+}
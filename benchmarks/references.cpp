@@ -0,0 +1,124 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// References spread over the first hundred columns, as the reader and
+// writer see them for the cells of a large worksheet.
+std::vector<xlnt::cell_reference> sample_references(int count)
+{
+    std::vector<xlnt::cell_reference> references;
+
+    for (int index = 0; index < count; index++)
+    {
+        references.emplace_back(static_cast<xlnt::column_t::index_t>(index % 100 + 1),
+            static_cast<xlnt::row_t>(index / 100 + 1));
+    }
+
+    return references;
+}
+
+void report(const std::string &name, int count, std::size_t elapsed, std::size_t checksum)
+{
+    std::cout << name << " " << count << ": " << elapsed / 1000.0 << "s (" << elapsed * 1000000.0 / count
+              << "ns per reference, checksum " << checksum << ")" << std::endl;
+}
+
+void parse(int count)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::vector<std::string> strings;
+
+    for (const auto &reference : sample_references(count))
+    {
+        strings.push_back(reference.to_string());
+    }
+
+    std::size_t checksum = 0;
+    auto start = current_time();
+
+    for (const auto &string : strings)
+    {
+        checksum += xlnt::cell_reference(string).row();
+    }
+
+    report("parse from std::string", count, current_time() - start, checksum);
+
+    checksum = 0;
+    start = current_time();
+
+    for (const auto &string : strings)
+    {
+        checksum += xlnt::cell_reference::from_chars(string.data(), string.data() + string.size()).row();
+    }
+
+    report("parse from characters", count, current_time() - start, checksum);
+}
+
+void format(int count)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto references = sample_references(count);
+
+    std::size_t checksum = 0;
+    auto start = current_time();
+
+    for (const auto &reference : references)
+    {
+        checksum += reference.to_string().size();
+    }
+
+    report("format to std::string", count, current_time() - start, checksum);
+
+    char buffer[16];
+    checksum = 0;
+    start = current_time();
+
+    for (const auto &reference : references)
+    {
+        checksum += reference.to_chars(buffer);
+    }
+
+    report("format to characters", count, current_time() - start, checksum);
+}
+
+} // namespace
+
+int main()
+{
+    parse(1000000);
+    format(1000000);
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Fill a column with distinct strings. Each one must be checked against
+// the shared string table before it is added, so the cost per string
+// should stay flat as the table grows.
+void distinct_strings(int rows)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (int index = 0; index < rows; index++)
+    {
+        ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1)))
+            .value("string " + std::to_string(index));
+    }
+}
+
+// Add strings directly to the shared string table, repeating each one
+// ten times so that both the lookup hit and miss paths are measured.
+void repeated_strings(int count)
+{
+    xlnt::workbook wb;
+
+    for (int index = 0; index < count; index++)
+    {
+        wb.add_shared_string(xlnt::rich_text("string " + std::to_string(index / 10)));
+    }
+}
+
+void timer(std::function<void(int)> fn, const std::string &name, int count)
+{
+    using xlnt::benchmarks::current_time;
+
+    auto start = current_time();
+    fn(count);
+    auto elapsed = current_time() - start;
+
+    std::cout << name << " " << count << ": " << elapsed / 1000.0 << "s ("
+              << elapsed * 1000.0 / count << "us per string)" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    timer(&distinct_strings, "distinct strings", 10000);
+    timer(&distinct_strings, "distinct strings", 100000);
+    timer(&distinct_strings, "distinct strings", 1000000);
+
+    timer(&repeated_strings, "repeated strings", 100000);
+    timer(&repeated_strings, "repeated strings", 1000000);
+
+    return 0;
+}
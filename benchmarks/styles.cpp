@@ -153,6 +153,63 @@ xlnt::workbook non_optimized_workbook(int n)
     return wb;
 }
 
+// Give each cell one of the given number of distinct fonts and fills.
+// Every combination becomes its own format, so with the stylesheet
+// interning its contents the cost per cell shouldn't depend on how
+// many formats there are.
+void distinct_formats(int cells, int formats)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    std::vector<xlnt::font> fonts;
+    std::vector<xlnt::fill> fills;
+
+    for (int index = 0; index < formats; index++)
+    {
+        fonts.push_back(xlnt::font().size(8.0 + index));
+
+        const auto shade = static_cast<std::uint8_t>(index % 256);
+        const auto tint = static_cast<std::uint8_t>(index / 256);
+        fills.push_back(xlnt::fill::solid(xlnt::rgb_color(shade, tint, 0)));
+    }
+
+    auto start = current_time();
+
+    for (int index = 0; index < cells; index++)
+    {
+        auto cell = ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1)));
+        cell.font(fonts[static_cast<std::size_t>(index % formats)]);
+        cell.fill(fills[static_cast<std::size_t>(index % formats)]);
+    }
+
+    auto elapsed = current_time() - start;
+
+    std::cout << "styled " << cells << " cells with " << formats << " formats in " << elapsed / 1000.0 << "s ("
+              << elapsed * 1000.0 / cells << "us per cell)" << std::endl;
+}
+
+void range_styling(int rows, int columns)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+    auto range = ws.range(xlnt::range_reference(1, 1,
+        static_cast<xlnt::column_t::index_t>(columns), static_cast<xlnt::row_t>(rows)));
+
+    auto start = current_time();
+
+    range.font(xlnt::font().bold(true));
+    range.fill(xlnt::fill::solid(xlnt::color::yellow()));
+
+    auto elapsed = current_time() - start;
+
+    std::cout << "styled a range of " << rows * columns << " cells in " << elapsed / 1000.0 << "s" << std::endl;
+}
+
 void to_profile(xlnt::workbook &wb, const std::string &f, int n)
 {
     using xlnt::benchmarks::current_time;
@@ -173,5 +230,11 @@ int main()
     std::string f = "temp.xlsx";
     to_profile(wb, f, n);
 
+    distinct_formats(20000, 10);
+    distinct_formats(20000, 100);
+    distinct_formats(20000, 500);
+
+    range_styling(100000, 10);
+
     return 0;
 }
@@ -22,7 +22,10 @@
 // @author: see AUTHORS file
 
 #include <chrono>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <string>
 
 #include <helpers/timing.hpp>
 #include <xlnt/xlnt.hpp>
@@ -80,10 +83,64 @@ void timer(std::function<void(int, int)> fn, int cols, int rows)
     std::cout << time / 1000.0 << std::endl;
 }
 
+// Report the average time taken to get a cell with worksheet::cell and set its
+// value. The cells are created in row order and then updated in row order and
+// in column order, so this measures cell lookup and insertion without saving.
+void cell_access(int cols, int rows)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+    const auto cells = static_cast<double>(cols) * rows;
+
+    auto report = [cells](const std::string &name, std::size_t elapsed) {
+        std::cout << name << ": " << elapsed * 1000000.0 / cells << "ns per cell" << std::endl;
+    };
+
+    std::cout << cols << " cols " << rows << " rows cell access" << std::endl;
+
+    auto start = current_time();
+
+    for (int row = 1; row <= rows; row++)
+    {
+        for (int column = 1; column <= cols; column++)
+        {
+            ws.cell(xlnt::cell_reference(column, row)).value(column);
+        }
+    }
+
+    report("create in row order", current_time() - start);
+    start = current_time();
+
+    for (int row = 1; row <= rows; row++)
+    {
+        for (int column = 1; column <= cols; column++)
+        {
+            ws.cell(xlnt::cell_reference(column, row)).value(row);
+        }
+    }
+
+    report("update in row order", current_time() - start);
+    start = current_time();
+
+    for (int column = 1; column <= cols; column++)
+    {
+        for (int row = 1; row <= rows; row++)
+        {
+            ws.cell(xlnt::cell_reference(column, row)).value(column);
+        }
+    }
+
+    report("update in column order", current_time() - start);
+}
+
 } // namespace
 
 int main()
 {
+    cell_access(100, 100000);
+
     timer(&writer, 100, 100);
     timer(&writer, 1000, 100);
     timer(&writer, 4000, 100);
@@ -484,6 +484,13 @@ public:
     /// </summary>
     std::string to_string() const;
 
+    /// <summary>
+    /// Replaces the contents of result with a string representing the value of
+    /// this cell as to_string() would. Reusing the same result string for many
+    /// cells avoids allocating a new string for each one.
+    /// </summary>
+    void to_string(std::string &result) const;
+
     // merging
 
     /// <summary>
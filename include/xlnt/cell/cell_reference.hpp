@@ -71,6 +71,12 @@ public:
     static std::pair<std::string, row_t> split_reference(
         const std::string &reference_string, bool &absolute_column, bool &absolute_row);
 
+    /// <summary>
+    /// Constructs a cell_reference from the characters in [first, last), such as
+    /// "$B14", without copying them or allocating.
+    /// </summary>
+    static cell_reference from_chars(const char *first, const char *last);
+
     // constructors
 
     /// <summary>
@@ -180,6 +186,14 @@ public:
     /// </summary>
     std::string to_string() const;
 
+    /// <summary>
+    /// Writes the string returned by to_string() to buffer without a terminating
+    /// null and returns the number of characters written. buffer must have room
+    /// for at least 19 characters, enough for "$" and seven column letters
+    /// followed by "$" and a ten-digit row.
+    /// </summary>
+    std::size_t to_chars(char *buffer) const;
+
     /// <summary>
     /// Returns a 1x1 range_reference containing only this cell_reference.
     /// </summary>
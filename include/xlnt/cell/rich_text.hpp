@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -110,6 +111,8 @@ public:
     bool operator!=(const std::string &rhs) const;
 
 private:
+    friend struct std::hash<rich_text>;
+
     /// <summary>
     /// The runs that make up this rich text.
     /// </summary>
@@ -117,3 +120,20 @@ private:
 };
 
 } // namespace xlnt
+
+namespace std {
+
+/// <summary>
+/// Template specialization to allow xlnt::rich_text to be used as a key in a std container.
+/// Only the text of each run is hashed, so texts differing only by font will collide.
+/// </summary>
+template <>
+struct XLNT_API hash<xlnt::rich_text>
+{
+    /// <summary>
+    /// Returns a hashed represenation of the given rich text.
+    /// </summary>
+    size_t operator()(const xlnt::rich_text &text) const;
+};
+
+} // namespace std
@@ -211,10 +211,17 @@ public:
     /// </summary>
     const class style style() const;
 
+    /// <summary>
+    /// Returns the index of this format in the workbook's stylesheet. This is
+    /// the value of the "s" attribute of cells using this format.
+    /// </summary>
+    std::size_t id() const;
+
 private:
     friend struct detail::stylesheet;
     friend class detail::xlsx_producer;
     friend class cell;
+    friend class worksheet;
 
     /// <summary>
     /// Constructs a format from an impl pointer.
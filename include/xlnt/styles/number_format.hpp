@@ -244,6 +244,20 @@ public:
     /// </summary>
     std::string format(long double number, calendar base_date) const;
 
+    /// <summary>
+    /// Replaces the contents of result with text formatted according to this
+    /// number format's format code. Reusing the same result string for many
+    /// values avoids allocating a new string for each one.
+    /// </summary>
+    void format(const std::string &text, std::string &result) const;
+
+    /// <summary>
+    /// Replaces the contents of result with number formatted according to this
+    /// number format's format code with the given base date. Reusing the same
+    /// result string for many values avoids allocating a new string for each one.
+    /// </summary>
+    void format(long double number, calendar base_date, std::string &result) const;
+
     /// <summary>
     /// Returns true if this format code returns a number formatted as a date.
     /// </summary>
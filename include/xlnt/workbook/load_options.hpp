@@ -0,0 +1,61 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Options that control how workbook::load reads an XLSX file.
+/// </summary>
+class XLNT_API load_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to decompress and parse worksheets. With the
+    /// default of 1, every worksheet is read on the calling thread. 0 uses one
+    /// thread per hardware thread. Shared strings and styles are always read
+    /// first on the calling thread.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// If true, load only reads the workbook part, shared strings, styles and
+    /// theme. Each worksheet is read when it is first returned by one of the
+    /// workbook's sheet_by_* functions, including through iteration and
+    /// active_sheet, so opening a workbook to use one of many worksheets costs
+    /// about as much as reading that worksheet. Copying or saving the workbook
+    /// reads every worksheet that hasn't been read yet. The file, or a copy of
+    /// the stream's data, is kept until then. worksheet_threads is ignored.
+    /// Because the first access reads and stores the worksheet, even const
+    /// access to a lazily loaded workbook isn't safe from several threads at
+    /// once without the caller's own synchronization.
+    /// </summary>
+    bool lazy_worksheets = false;
+};
+
+} // namespace xlnt
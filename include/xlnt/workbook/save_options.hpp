@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/packaging/relationship.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The method DEFLATE uses to find repeated data when compressing a part.
+/// </summary>
+enum class XLNT_API compression_strategy
+{
+    /// <summary>
+    /// Normal DEFLATE compression which is best for XML.
+    /// </summary>
+    default_strategy,
+    /// <summary>
+    /// Favours Huffman coding over string matching, intended for data consisting
+    /// of small values with a somewhat random distribution.
+    /// </summary>
+    filtered,
+    /// <summary>
+    /// Only uses Huffman coding without any string matching. This is much faster
+    /// but files are considerably larger.
+    /// </summary>
+    huffman_only,
+    /// <summary>
+    /// Only matches runs of the same byte. This is nearly as fast as huffman_only
+    /// and slightly smaller for data with long runs.
+    /// </summary>
+    run_length,
+    /// <summary>
+    /// Uses fixed Huffman codes rather than computing them for each block.
+    /// </summary>
+    fixed
+};
+
+/// <summary>
+/// Options that control how workbook::save writes an XLSX file.
+/// </summary>
+class XLNT_API save_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to compress each part of the file. With the
+    /// default of 1, everything is compressed on the calling thread. Otherwise,
+    /// parts are split into 256 KiB blocks which are compressed concurrently.
+    /// Blocks don't share history, so files are slightly larger. 0 uses one
+    /// thread per hardware thread.
+    /// </summary>
+    std::size_t compression_threads = 1;
+
+    /// <summary>
+    /// The DEFLATE compression level from 1, which is fastest, to 9, which gives
+    /// the smallest files. 0 stores parts without any compression, which is
+    /// fastest of all but gives much larger files. The default is 6.
+    /// </summary>
+    int compression_level = 6;
+
+    /// <summary>
+    /// Compression levels for parts with the given relationship types, for
+    /// example relationship_type::worksheet or relationship_type::image, which
+    /// override compression_level. Parts that aren't the target of a relationship,
+    /// such as [Content_Types].xml and relationship parts, always use compression_level.
+    /// </summary>
+    std::map<relationship_type, int> part_compression_levels;
+
+    /// <summary>
+    /// The method used to find repeated data when compressing parts.
+    /// </summary>
+    compression_strategy strategy = compression_strategy::default_strategy;
+
+    /// <summary>
+    /// If true, the workbook's unused formats and style components are removed
+    /// as by workbook::compact_styles before it is written.
+    /// </summary>
+    bool compact_styles = false;
+};
+
+} // namespace xlnt
@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/utils/optional.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// A single cell of a row read by streaming_reader or written by streaming_writer.
+/// The text of shared_string cells is stored directly rather than as an index.
+/// </summary>
+struct XLNT_API streamed_cell
+{
+    /// <summary>
+    /// The location of this cell in the worksheet. When writing, only the
+    /// column is used and the row is taken from the containing streamed_row.
+    /// </summary>
+    cell_reference reference;
+
+    /// <summary>
+    /// The type of value in this cell.
+    /// </summary>
+    cell_type type = cell_type::empty;
+
+    /// <summary>
+    /// The value of a numeric cell, or 0/1 for a boolean cell.
+    /// </summary>
+    long double number = 0;
+
+    /// <summary>
+    /// The value of a string cell or the code of an error cell.
+    /// </summary>
+    std::string text;
+
+    /// <summary>
+    /// The formula of this cell without a leading '=', if it has one.
+    /// </summary>
+    optional<std::string> formula;
+
+    /// <summary>
+    /// The index of this cell's format in the workbook's stylesheet, if it has one.
+    /// This can be passed to workbook::format(index) on the workbook of the
+    /// reader or writer.
+    /// </summary>
+    optional<std::size_t> format_id;
+};
+
+/// <summary>
+/// A single row of a worksheet read by streaming_reader or written by streaming_writer.
+/// Only cells present in the file are included and they are in column order.
+/// </summary>
+struct XLNT_API streamed_row
+{
+    /// <summary>
+    /// The 1-based index of this row. When writing, 0 means the row after
+    /// the previously written one.
+    /// </summary>
+    row_t index = 0;
+
+    /// <summary>
+    /// The cells in this row.
+    /// </summary>
+    std::vector<streamed_cell> cells;
+};
+
+} // namespace xlnt
@@ -0,0 +1,144 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/workbook/streamed_row.hpp>
+
+namespace xlnt {
+
+class path;
+class workbook;
+
+namespace detail {
+
+class xlsx_consumer;
+
+} // namespace detail
+
+/// <summary>
+/// Reads the cells of a worksheet one row at a time without loading the
+/// whole worksheet into memory. Shared strings and styles are read when the
+/// file is opened, so memory use is bounded by those and by the width of the
+/// widest row rather than by the number of rows.
+/// </summary>
+class XLNT_API streaming_reader
+{
+public:
+    /// <summary>
+    /// Constructs a reader with no file open.
+    /// </summary>
+    streaming_reader();
+
+    /// <summary>
+    /// Closes any open file.
+    /// </summary>
+    ~streaming_reader();
+
+    /// <summary>
+    /// Opens the XLSX file at filename and reads its workbook part, shared strings
+    /// and stylesheet. No worksheets are read until begin_worksheet is called.
+    /// </summary>
+    void open(const std::string &filename);
+
+    /// <summary>
+    /// Opens the XLSX file at filename and reads its workbook part, shared strings
+    /// and stylesheet. No worksheets are read until begin_worksheet is called.
+    /// </summary>
+    void open(const xlnt::path &filename);
+
+    /// <summary>
+    /// Opens the XLSX data in stream and reads its workbook part, shared strings
+    /// and stylesheet. The stream must stay valid until close is called.
+    /// </summary>
+    void open(std::istream &stream);
+
+    /// <summary>
+    /// Closes the currently open file, if any.
+    /// </summary>
+    void close();
+
+    /// <summary>
+    /// Returns the titles of all worksheets in the open file in workbook order.
+    /// </summary>
+    std::vector<std::string> sheet_titles() const;
+
+    /// <summary>
+    /// Starts reading the worksheet with the given title. Any worksheet that
+    /// is currently being read is ended first.
+    /// </summary>
+    void begin_worksheet(const std::string &title);
+
+    /// <summary>
+    /// Returns true if there is at least one more row in the current worksheet.
+    /// </summary>
+    bool has_row();
+
+    /// <summary>
+    /// Reads the next row of the current worksheet. The returned reference
+    /// is only valid until the next call to read_row since the same storage
+    /// is reused for every row.
+    /// </summary>
+    const streamed_row &read_row();
+
+    /// <summary>
+    /// Stops reading the current worksheet. The remainder of the part is not parsed.
+    /// </summary>
+    void end_worksheet();
+
+    /// <summary>
+    /// Returns the workbook holding the stylesheet, shared strings and
+    /// properties of the open file. It contains no worksheets.
+    /// </summary>
+    const xlnt::workbook &workbook() const;
+
+private:
+    /// <summary>
+    /// The file opened by open(filename), if any.
+    /// </summary>
+    std::unique_ptr<std::ifstream> file_;
+
+    /// <summary>
+    /// The workbook that receives everything but worksheet cells.
+    /// </summary>
+    std::unique_ptr<xlnt::workbook> workbook_;
+
+    /// <summary>
+    /// The consumer that reads the open file.
+    /// </summary>
+    std::unique_ptr<detail::xlsx_consumer> consumer_;
+
+    /// <summary>
+    /// Storage reused for each row returned by read_row.
+    /// </summary>
+    streamed_row row_;
+};
+
+} // namespace xlnt
@@ -0,0 +1,143 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/workbook/streamed_row.hpp>
+
+namespace xlnt {
+
+class path;
+class workbook;
+
+namespace detail {
+
+class xlsx_producer;
+
+} // namespace detail
+
+/// <summary>
+/// Writes worksheets one row at a time directly into an XLSX archive without
+/// holding the cells in memory. The stylesheet, shared strings and all other
+/// parts of the workbook are written when the writer is closed, so formats
+/// can be created on workbook() at any time before that.
+/// </summary>
+class XLNT_API streaming_writer
+{
+public:
+    /// <summary>
+    /// Constructs a writer with no file open.
+    /// </summary>
+    streaming_writer();
+
+    /// <summary>
+    /// Closes the writer, finishing the file if one is open.
+    /// </summary>
+    ~streaming_writer();
+
+    /// <summary>
+    /// Creates the XLSX file at filename and prepares to write worksheets to it.
+    /// </summary>
+    void open(const std::string &filename);
+
+    /// <summary>
+    /// Creates the XLSX file at filename and prepares to write worksheets to it.
+    /// </summary>
+    void open(const xlnt::path &filename);
+
+    /// <summary>
+    /// Prepares to write an XLSX archive to stream. The stream must stay valid
+    /// until close is called.
+    /// </summary>
+    void open(std::ostream &stream);
+
+    /// <summary>
+    /// Ends the current worksheet and writes the rest of the workbook.
+    /// Nothing is written after this until open is called again.
+    /// </summary>
+    void close();
+
+    /// <summary>
+    /// Adds a worksheet with the given title to the workbook and starts writing
+    /// rows to it. Any worksheet that is currently being written is ended first.
+    /// </summary>
+    void begin_worksheet(const std::string &title);
+
+    /// <summary>
+    /// Writes row to the end of the current worksheet. Rows must be appended in
+    /// ascending order of index and cells in strictly ascending order of column,
+    /// otherwise invalid_parameter is thrown and nothing is written. The text
+    /// of shared_string cells is added to the workbook's shared string table.
+    /// </summary>
+    void append_row(const streamed_row &row);
+
+    /// <summary>
+    /// Ends the current worksheet. Rows can't be added to it afterwards.
+    /// </summary>
+    void end_worksheet();
+
+    /// <summary>
+    /// Returns the workbook which will be written when the writer is closed.
+    /// Its worksheets have no cells, but formats created on it can be
+    /// referenced by id from streamed_cell::format_id. Formats up to the highest
+    /// id used by an appended row are kept and keep their ids if the workbook's
+    /// styles are compacted.
+    /// </summary>
+    xlnt::workbook &workbook();
+
+private:
+    /// <summary>
+    /// The file created by open(filename), if any.
+    /// </summary>
+    std::unique_ptr<std::ofstream> file_;
+
+    /// <summary>
+    /// The workbook which holds everything but worksheet cells.
+    /// </summary>
+    std::unique_ptr<xlnt::workbook> workbook_;
+
+    /// <summary>
+    /// The producer that writes the open file.
+    /// </summary>
+    std::unique_ptr<detail::xlsx_producer> producer_;
+
+    /// <summary>
+    /// True until the first call to begin_worksheet, which reuses the
+    /// empty worksheet every new workbook starts with.
+    /// </summary>
+    bool default_worksheet_unused_ = true;
+
+    /// <summary>
+    /// Storage reused by append_row for the shared string indices of a row.
+    /// </summary>
+    std::vector<std::size_t> shared_string_indices_;
+};
+
+} // namespace xlnt
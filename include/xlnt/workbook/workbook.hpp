@@ -52,7 +52,9 @@ class drawing;
 class fill;
 class font;
 class format;
+class load_options;
 class rich_text;
+class save_options;
 class manifest;
 class metadata_property;
 class named_range;
@@ -192,6 +194,9 @@ public:
     /// Returns the worksheet with the given name. This may throw an exception
     /// if the sheet isn't found. Use workbook::contains(const std::string &)
     /// to make sure the sheet exists before calling this method.
+    /// If the workbook was loaded with load_options::lazy_worksheets, this
+    /// may read the worksheet and so modify the workbook despite being const.
+    /// Concurrent calls must then be synchronized by the caller.
     /// </summary>
     const worksheet sheet_by_title(const std::string &title) const;
 
@@ -204,6 +209,9 @@ public:
     /// <summary>
     /// Returns the worksheet at the given index. This will throw an exception
     /// if index is greater than or equal to the number of sheets in this workbook.
+    /// If the workbook was loaded with load_options::lazy_worksheets, this
+    /// may read the worksheet and so modify the workbook despite being const.
+    /// Concurrent calls must then be synchronized by the caller.
     /// </summary>
     const worksheet sheet_by_index(std::size_t index) const;
 
@@ -216,6 +224,9 @@ public:
     /// <summary>
     /// Returns the worksheet with a sheetId of id. Sheet IDs are arbitrary numbers
     /// that uniquely identify a sheet. Most users won't need this.
+    /// If the workbook was loaded with load_options::lazy_worksheets, this
+    /// may read the worksheet and so modify the workbook despite being const.
+    /// Concurrent calls must then be synchronized by the caller.
     /// </summary>
     const worksheet sheet_by_id(std::size_t id) const;
 
@@ -473,6 +484,12 @@ public:
     /// </summary>
     void save(const xlnt::path &filename, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename, writing it as specified by options.
+    /// </summary>
+    void save(const xlnt::path &filename, const save_options &options) const;
+
     /// <summary>
     /// Serializes the workbook into an XLSX file and saves the data into stream.
     /// </summary>
@@ -484,6 +501,12 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into stream,
+    /// writing it as specified by options.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -524,7 +547,8 @@ public:
 
     /// <summary>
     /// Interprets file with the given filename as an XLSX file and sets the
-    /// content of this workbook to match that file.
+    /// content of this workbook to match that file. The file is mapped into
+    /// memory and read in place where possible.
     /// </summary>
     void load(const xlnt::path &filename);
 
@@ -534,6 +558,13 @@ public:
     /// </summary>
     void load(const xlnt::path &filename, const std::string &password);
 
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file, reading it as specified
+    /// by options.
+    /// </summary>
+    void load(const xlnt::path &filename, const load_options &options);
+
     /// <summary>
     /// Interprets data in stream as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -546,6 +577,12 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets data in stream as an XLSX file and sets the content of this
+    /// workbook to match that file, reading it as specified by options.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
     // View
 
     /// <summary>
@@ -641,6 +678,14 @@ public:
     /// </summary>
     xlnt::format create_format(bool default_format = false);
 
+    /// <summary>
+    /// Removes formats that are no longer used by any cell along with any fonts,
+    /// fills, borders, alignments and protections that are no longer used by
+    /// the remaining formats, styles or conditional formats. Format objects
+    /// referring to removed formats are invalidated.
+    /// </summary>
+    void compact_styles();
+
     /// <summary>
     /// Clear all cell-level formatting and formats from the styelsheet. This leaves
     /// all other styling in place (e.g. named styles).
@@ -705,7 +750,10 @@ public:
 
     /// <summary>
     /// Returns a reference to the shared strings being used by cells
-    /// in this workbook.
+    /// in this workbook. The index add_shared_string uses to find existing
+    /// strings is rebuilt after each call, so call this again rather than
+    /// keeping the reference when changing strings between calls to
+    /// add_shared_string.
     /// </summary>
     std::vector<rich_text> &shared_strings();
 
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -48,6 +49,7 @@ class condition;
 class conditional_format;
 class const_range_iterator;
 class footer;
+class format;
 class header;
 class range;
 class range_iterator;
@@ -663,9 +665,16 @@ public:
 	/// </summary>
 	xlnt::conditional_format conditional_format(const range_reference &ref, const condition &when);
 
+    /// <summary>
+    /// Sets the format of every cell in reference to new_format, creating cells
+    /// as needed. This is much faster than setting the format of each cell in turn.
+    /// </summary>
+    void format(const range_reference &reference, const class format &new_format);
+
 private:
     friend class cell;
     friend class const_range_iterator;
+    friend class range;
     friend class range_iterator;
     friend class workbook;
     friend class detail::xlsx_consumer;
@@ -690,6 +699,16 @@ private:
     /// Removes calcChain part from manifest if no formulae remain in workbook.
     /// </summary>
     void garbage_collect_formulae();
+
+    /// <summary>
+    /// Sets the format of every cell in reference to the format returned by derive.
+    /// derive is called once for each distinct format of those cells, and once with
+    /// a new blank format if any of them have no format, rather than once per cell.
+    /// If skip_null is true, cells that don't exist yet are left alone instead of
+    /// being created.
+    /// </summary>
+    void restyle(const range_reference &reference, bool skip_null,
+        const std::function<class format(class format)> &derive);
     
     /// <summary>
     /// Sets the parent of this worksheet to wb.
@@ -64,7 +64,12 @@
 #include <xlnt/workbook/document_security.hpp>
 #include <xlnt/workbook/external_book.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/save_options.hpp>
+#include <xlnt/workbook/streamed_row.hpp>
+#include <xlnt/workbook/streaming_reader.hpp>
+#include <xlnt/workbook/streaming_writer.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/worksheet_iterator.hpp>
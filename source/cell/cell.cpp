@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <sstream>
 
 #include <detail/implementations/cell_impl.hpp>
@@ -204,50 +205,50 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
-    d_->type_ = type::boolean;
+    d_->type(type::boolean);
     d_->value_numeric_ = boolean_value ? 1.0L : 0.0L;
 }
 
 void cell::value(int int_value)
 {
     d_->value_numeric_ = static_cast<long double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(unsigned int int_value)
 {
     d_->value_numeric_ = static_cast<long double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(long long int int_value)
 {
     d_->value_numeric_ = static_cast<long double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(unsigned long long int int_value)
 {
     d_->value_numeric_ = static_cast<long double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(float float_value)
 {
     d_->value_numeric_ = static_cast<long double>(float_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(double float_value)
 {
     d_->value_numeric_ = static_cast<long double>(float_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(long double d)
 {
     d_->value_numeric_ = d;
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(const std::string &s)
@@ -259,7 +260,7 @@ void cell::value(const rich_text &text)
 {
     check_string(text.plain_text());
 
-    d_->type_ = type::shared_string;
+    d_->type(type::shared_string);
     d_->value_numeric_ = static_cast<long double>(workbook().add_shared_string(text));
 }
 
@@ -270,38 +271,33 @@ void cell::value(const char *c)
 
 void cell::value(const cell c)
 {
-    d_->type_ = c.d_->type_;
-    d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
-    d_->format_ = c.d_->format_;
+    d_->copy_contents(*c.d_);
 }
 
 void cell::value(const date &d)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
 }
 
 void cell::value(const datetime &d)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
 }
 
 void cell::value(const time &t)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
 }
 
 void cell::value(const timedelta &t)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = t.to_number();
     number_format(xlnt::number_format("[hh]:mm:ss"));
 }
@@ -348,23 +344,20 @@ bool cell::operator==(const cell &comparand) const
 
 cell &cell::operator=(const cell &rhs)
 {
-    d_->column_ = rhs.d_->column_;
-    d_->format_ = rhs.d_->format_;
-    d_->formula_ = rhs.d_->formula_;
-    d_->hyperlink_ = rhs.d_->hyperlink_;
+    d_->copy_contents(*rhs.d_);
     d_->is_merged_ = rhs.d_->is_merged_;
-    d_->parent_ = rhs.d_->parent_;
-    d_->row_ = rhs.d_->row_;
-    d_->type_ = rhs.d_->type_;
-    d_->value_numeric_ = rhs.d_->value_numeric_;
-    d_->value_text_ = rhs.d_->value_text_;
 
     return *this;
 }
 
 std::string cell::hyperlink() const
 {
-    return d_->hyperlink_.get();
+    if (!has_hyperlink())
+    {
+        throw invalid_attribute();
+    }
+
+    return d_->hyperlink();
 }
 
 void cell::hyperlink(const std::string &hyperlink)
@@ -374,7 +367,7 @@ void cell::hyperlink(const std::string &hyperlink)
         throw invalid_parameter();
     }
 
-    d_->hyperlink_ = hyperlink;
+    d_->hyperlink(hyperlink);
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
@@ -397,11 +390,11 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        d_->formula(formula.substr(1));
     }
     else
     {
-        d_->formula_ = formula;
+        d_->formula(formula);
     }
 
     data_type(type::number);
@@ -411,19 +404,24 @@ void cell::formula(const std::string &formula)
 
 bool cell::has_formula() const
 {
-    return d_->formula_.is_set();
+    return d_->has_formula_;
 }
 
 std::string cell::formula() const
 {
-    return d_->formula_.get();
+    if (!has_formula())
+    {
+        throw invalid_attribute();
+    }
+
+    return d_->formula();
 }
 
 void cell::clear_formula()
 {
     if (has_formula())
     {
-        d_->formula_.clear();
+        d_->clear_formula();
         worksheet().garbage_collect_formulae();
     }
 }
@@ -435,8 +433,8 @@ void cell::error(const std::string &error)
         throw invalid_data_type();
     }
 
-    d_->value_text_.plain_text(error);
-    d_->type_ = type::error;
+    d_->value_text(rich_text(error));
+    d_->type(type::error);
 }
 
 cell cell::offset(int column, int row)
@@ -490,7 +488,7 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
-    d_->type_ = t;
+    d_->type(t);
 }
 
 number_format cell::computed_number_format() const
@@ -526,8 +524,7 @@ protection cell::computed_protection() const
 void cell::clear_value()
 {
     d_->value_numeric_ = 0;
-    d_->value_text_.clear();
-    d_->type_ = cell::type::empty;
+    d_->type(cell::type::empty);
     clear_formula();
 }
 
@@ -653,7 +650,7 @@ XLNT_API rich_text cell::value() const
         return workbook().shared_strings().at(static_cast<std::size_t>(d_->value_numeric_));
     }
 
-    return d_->value_text_;
+    return d_->value_text();
 }
 
 bool cell::has_value() const
@@ -661,40 +658,51 @@ bool cell::has_value() const
     return d_->type_ != cell::type::empty;
 }
 
-std::string cell::to_string() const
+void cell::to_string(std::string &result) const
 {
-    auto nf = computed_number_format();
+    const auto nf = computed_number_format();
 
     switch (data_type())
     {
     case cell::type::empty:
-        return "";
+        result.clear();
+        return;
     case cell::type::number:
-        return nf.format(value<long double>(), base_date());
+        return nf.format(value<long double>(), base_date(), result);
     case cell::type::inline_string:
     case cell::type::shared_string:
     case cell::type::formula_string:
     case cell::type::error:
-        return nf.format(value<std::string>());
+        return nf.format(value<std::string>(), result);
     case cell::type::boolean:
-        return value<long double>() == 0.L ? "FALSE" : "TRUE";
+        result.assign(value<long double>() == 0.L ? "FALSE" : "TRUE");
+        return;
     case cell::type::date:
-        return "DD-MMM-YY";
+        result.assign("DD-MMM-YY");
+        return;
     }
 
-    return "";
+    result.clear();
+}
+
+std::string cell::to_string() const
+{
+    std::string result;
+    to_string(result);
+
+    return result;
 }
 
 bool cell::has_format() const
 {
-    return d_->format_.is_set();
+    return d_->format_ != nullptr;
 }
 
 void cell::format(const class format new_format)
 {
     if (has_format())
     {
-        format().d_->references -= format().d_->references > 0 ? 1 : 0;
+        d_->format_->parent->release_format(*d_->format_);
     }
 
     ++new_format.d_->references;
@@ -737,7 +745,7 @@ void cell::value(const std::string &value_string, bool infer_type)
     if (percentage.first)
     {
         d_->value_numeric_ = percentage.second;
-        d_->type_ = cell::type::number;
+        d_->type(cell::type::number);
         number_format(xlnt::number_format::percentage());
     }
     else
@@ -746,7 +754,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
         if (time.first)
         {
-            d_->type_ = cell::type::number;
+            d_->type(cell::type::number);
             number_format(number_format::date_time6());
             d_->value_numeric_ = time.second.to_number();
         }
@@ -757,7 +765,7 @@ void cell::value(const std::string &value_string, bool infer_type)
             if (numeric.first)
             {
                 d_->value_numeric_ = numeric.second;
-                d_->type_ = cell::type::number;
+                d_->type(cell::type::number);
             }
         }
     }
@@ -765,8 +773,8 @@ void cell::value(const std::string &value_string, bool infer_type)
 
 void cell::clear_format()
 {
-    format().d_->references -= format().d_->references > 0 ? 1 : 0;
-    d_->format_.clear();
+    d_->format_->parent->release_format(*d_->format_);
+    d_->format_ = nullptr;
 }
 
 void cell::clear_style()
@@ -817,22 +825,22 @@ bool cell::has_style() const
 
 format cell::modifiable_format()
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 const format cell::format() const
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 alignment cell::alignment() const
@@ -867,19 +875,19 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_.is_set();
+    return d_->has_hyperlink_;
 }
 
 // comment
 
 bool cell::has_comment()
 {
-    return d_->comment_.is_set();
+    return d_->has_comment_;
 }
 
 void cell::clear_comment()
 {
-    d_->comment_.clear();
+    d_->clear_comment();
 }
 
 class comment cell::comment()
@@ -889,7 +897,7 @@ class comment cell::comment()
         throw xlnt::exception("cell has no comment");
     }
 
-    return d_->comment_.get();
+    return d_->comment();
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -905,15 +913,15 @@ void cell::comment(const std::string &text, const class font &comment_font, cons
 
 void cell::comment(const class comment &new_comment)
 {
-    d_->comment_.set(new_comment);
+    d_->comment(new_comment);
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
     auto cell_position = anchor();
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_.get().position(cell_position.first, cell_position.second);
-    d_->comment_.get().size(200, 100);
+    d_->comment().position(cell_position.first, cell_position.second);
+    d_->comment().size(200, 100);
 
     worksheet().register_comments_in_manifest();
 }
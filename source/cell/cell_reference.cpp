@@ -22,13 +22,88 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
-#include <locale>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 #include <xlnt/cell/cell_reference.hpp>
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
 
 #include <detail/constants.hpp>
+#include <detail/reference_chars.hpp>
+
+namespace {
+
+/// <summary>
+/// The parts of a string like "$AB$12" that split_parts finds without copying.
+/// </summary>
+struct reference_parts
+{
+    const char *column_first;
+    const char *column_last;
+    xlnt::row_t row;
+    bool absolute_column;
+    bool absolute_row;
+};
+
+// Splits [first, last) into the column letters and row number of a reference,
+// each optionally preceded by '$'. The letters aren't checked to be a valid
+// column, but everything else must be well-formed.
+reference_parts split_parts(const char *first, const char *last)
+{
+    reference_parts parts{first, first, 0, false, false};
+    auto position = first;
+
+    if (position != last && *position == '$')
+    {
+        parts.absolute_column = true;
+        parts.column_first = ++position;
+    }
+
+    while (position != last && xlnt::detail::column_letter_value(*position) != 0)
+    {
+        ++position;
+    }
+
+    parts.column_last = position;
+
+    if (position != last && *position == '$')
+    {
+        parts.absolute_row = true;
+        ++position;
+    }
+
+    if (position == last)
+    {
+        throw xlnt::invalid_cell_reference(std::string(first, last));
+    }
+
+    std::uint64_t row = 0;
+
+    for (; position != last; ++position)
+    {
+        const auto digit = static_cast<unsigned int>(static_cast<unsigned char>(*position)) - '0';
+
+        if (digit > 9)
+        {
+            throw xlnt::invalid_cell_reference(std::string(first, last));
+        }
+
+        row = row * 10 + digit;
+
+        if (row > std::numeric_limits<xlnt::row_t>::max())
+        {
+            throw xlnt::invalid_cell_reference(std::string(first, last));
+        }
+    }
+
+    parts.row = static_cast<xlnt::row_t>(row);
+
+    return parts;
+}
+
+} // namespace
 
 namespace xlnt {
 
@@ -51,16 +126,39 @@ cell_reference::cell_reference()
 }
 
 cell_reference::cell_reference(const std::string &string)
+    : cell_reference(from_chars(string.data(), string.data() + string.size()))
 {
-    auto split = split_reference(string, absolute_column_, absolute_row_);
-
-    column(split.first);
-    row(split.second);
 }
 
 cell_reference::cell_reference(const char *reference_string)
-    : cell_reference(std::string(reference_string))
+    : cell_reference(from_chars(reference_string, reference_string + std::strlen(reference_string)))
+{
+}
+
+cell_reference cell_reference::from_chars(const char *first, const char *last)
 {
+    const auto parts = split_parts(first, last);
+    const auto letters = parts.column_last - parts.column_first;
+
+    if (letters < 1 || letters > 3)
+    {
+        throw invalid_column_index();
+    }
+
+    column_t::index_t column = 0;
+
+    for (auto letter = parts.column_first; letter != parts.column_last; ++letter)
+    {
+        column = column * 26 + detail::column_letter_value(*letter);
+    }
+
+    cell_reference result;
+    result.column_ = column;
+    result.row_ = parts.row;
+    result.absolute_column_ = parts.absolute_column;
+    result.absolute_row_ = parts.absolute_row;
+
+    return result;
 }
 
 cell_reference::cell_reference(column_t column_index, row_t row)
@@ -79,23 +177,35 @@ range_reference cell_reference::operator,(const xlnt::cell_reference &other) con
 
 std::string cell_reference::to_string() const
 {
-    std::string string_representation;
+    char buffer[detail::max_reference_chars];
+    return std::string(buffer, to_chars(buffer));
+}
+
+std::size_t cell_reference::to_chars(char *buffer) const
+{
+    // the largest index still fits in max_column_letters so only 0 is out of range
+    if (column_.index < constants::min_column().index)
+    {
+        throw invalid_column_index();
+    }
+
+    auto position = buffer;
 
     if (absolute_column_)
     {
-        string_representation.append("$");
+        *position++ = '$';
     }
 
-    string_representation.append(column_.column_string());
+    position += detail::write_column_letters(column_.index, position);
 
     if (absolute_row_)
     {
-        string_representation.append("$");
+        *position++ = '$';
     }
 
-    string_representation.append(std::to_string(row_));
+    position += detail::write_row_number(row_, position);
 
-    return string_representation;
+    return static_cast<std::size_t>(position - buffer);
 }
 
 range_reference cell_reference::to_range() const
@@ -112,76 +222,19 @@ std::pair<std::string, row_t> cell_reference::split_reference(const std::string
 std::pair<std::string, row_t> cell_reference::split_reference(
     const std::string &reference_string, bool &absolute_column, bool &absolute_row)
 {
-    absolute_column = false;
-    absolute_row = false;
+    const auto parts = split_parts(reference_string.data(), reference_string.data() + reference_string.size());
 
-    // Convert a coordinate string like 'B12' to a tuple ('B', 12)
-    bool column_part = true;
+    std::string column_string(parts.column_first, parts.column_last);
 
-    std::string column_string;
-
-    for (auto character : reference_string)
+    for (auto &character : column_string)
     {
-        char upper = std::toupper(character, std::locale::classic());
-
-        if (std::isalpha(character, std::locale::classic()))
-        {
-            if (column_part)
-            {
-                column_string.append(1, upper);
-            }
-            else
-            {
-                throw invalid_cell_reference(reference_string);
-            }
-        }
-        else if (character == '$')
-        {
-            if (column_part)
-            {
-                if (column_string.empty())
-                {
-                    column_string.append(1, upper);
-                }
-                else
-                {
-                    column_part = false;
-                }
-            }
-        }
-        else
-        {
-            if (column_part)
-            {
-                column_part = false;
-            }
-            else if (!std::isdigit(character, std::locale::classic()))
-            {
-                throw invalid_cell_reference(reference_string);
-            }
-        }
+        character = static_cast<char>('A' + detail::column_letter_value(character) - 1);
     }
 
-    std::string row_string = reference_string.substr(column_string.length());
-
-    if (row_string.length() == 0)
-    {
-        throw invalid_cell_reference(reference_string);
-    }
-
-    if (column_string[0] == '$')
-    {
-        absolute_row = true;
-        column_string = column_string.substr(1);
-    }
-
-    if (row_string[0] == '$')
-    {
-        absolute_column = true;
-        row_string = row_string.substr(1);
-    }
+    absolute_column = parts.absolute_column;
+    absolute_row = parts.absolute_row;
 
-    return {column_string, std::stoi(row_string)};
+    return {column_string, parts.row};
 }
 
 bool cell_reference::column_absolute() const
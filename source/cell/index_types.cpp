@@ -21,11 +21,10 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
-#include <locale>
-
 #include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/exceptions.hpp>
 #include <detail/constants.hpp>
+#include <detail/reference_chars.hpp>
 
 namespace xlnt {
 
@@ -37,28 +36,23 @@ column_t::index_t column_t::column_index_from_string(const std::string &column_s
     }
 
     column_t::index_t column_index = 0;
-    int place = 1;
 
-    for (int i = static_cast<int>(column_string.length()) - 1; i >= 0; i--)
+    for (auto character : column_string)
     {
-        if (!std::isalpha(column_string[static_cast<std::size_t>(i)], std::locale::classic()))
+        const auto letter = detail::column_letter_value(character);
+
+        if (letter == 0)
         {
             throw invalid_column_index();
         }
 
-        auto char_index = std::toupper(column_string[static_cast<std::size_t>(i)], std::locale::classic()) - 'A';
-
-        column_index += static_cast<column_t::index_t>((char_index + 1) * place);
-        place *= 26;
+        column_index = column_index * 26 + letter;
     }
 
     return column_index;
 }
 
 // Convert a column number into a column letter (3 -> 'C')
-// Right shift the column col_idx by 26 to find column letters in reverse
-// order.These numbers are 1 - based, and can be converted to ASCII
-// ordinals by adding 64.
 std::string column_t::column_string_from_index(column_t::index_t column_index)
 {
     // these indicies corrospond to A->ZZZ and include all allowed
@@ -68,25 +62,8 @@ std::string column_t::column_string_from_index(column_t::index_t column_index)
         throw invalid_column_index();
     }
 
-    int temp = static_cast<int>(column_index);
-    std::string column_letter = "";
-
-    while (temp > 0)
-    {
-        int quotient = temp / 26, remainder = temp % 26;
-
-        // check for exact division and borrow if needed
-        if (remainder == 0)
-        {
-            quotient -= 1;
-            remainder = 26;
-        }
-
-        column_letter = std::string(1, char(remainder + 64)) + column_letter;
-        temp = quotient;
-    }
-
-    return column_letter;
+    char letters[detail::max_column_letters];
+    return std::string(letters, detail::write_column_letters(column_index, letters));
 }
 
 column_t::column_t()
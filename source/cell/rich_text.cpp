@@ -98,3 +98,27 @@ bool rich_text::operator!=(const std::string &rhs) const
 }
 
 } // namespace xlnt
+
+namespace std {
+
+size_t hash<xlnt::rich_text>::operator()(const xlnt::rich_text &text) const
+{
+    static hash<string> hasher;
+
+    // fast path for the common case of a single run of plain text
+    if (text.runs_.size() == 1)
+    {
+        return hasher(text.runs_.front().first);
+    }
+
+    auto seed = text.runs_.size();
+
+    for (const auto &run : text.runs_)
+    {
+        seed ^= hasher(run.first) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+}
+
+} // namespace std
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <array>
+#include <stdexcept>
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -23,20 +23,185 @@
 // @author: see AUTHORS file
 #include <xlnt/worksheet/worksheet.hpp>
 
-#include "cell_impl.hpp"
+#include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
 
 namespace xlnt {
 namespace detail {
 
 cell_impl::cell_impl()
-    : type_(cell_type::empty),
+    : value_numeric_(0),
       parent_(nullptr),
+      format_(nullptr),
       column_(1),
       row_(1),
+      type_(cell_type::empty),
       is_merged_(false),
-      value_numeric_(0)
+      has_text_(false),
+      has_formula_(false),
+      has_hyperlink_(false),
+      has_comment_(false)
 {
 }
 
+void cell_impl::type(cell_type new_type)
+{
+    if (new_type != cell_type::inline_string && new_type != cell_type::formula_string
+        && new_type != cell_type::error)
+    {
+        clear_value_text();
+    }
+
+    type_ = new_type;
+}
+
+const rich_text &cell_impl::value_text() const
+{
+    static const rich_text empty;
+
+    if (!has_text_)
+    {
+        return empty;
+    }
+
+    return parent_->cell_text_.at(cell_reference(column_, row_));
+}
+
+void cell_impl::value_text(const rich_text &text)
+{
+    parent_->cell_text_[cell_reference(column_, row_)] = text;
+    has_text_ = true;
+}
+
+void cell_impl::clear_value_text()
+{
+    if (has_text_)
+    {
+        parent_->cell_text_.erase(cell_reference(column_, row_));
+        has_text_ = false;
+    }
+}
+
+const std::string &cell_impl::formula() const
+{
+    return parent_->formulae_.at(cell_reference(column_, row_));
+}
+
+void cell_impl::formula(const std::string &formula)
+{
+    parent_->formulae_[cell_reference(column_, row_)] = formula;
+    has_formula_ = true;
+}
+
+void cell_impl::clear_formula()
+{
+    if (has_formula_)
+    {
+        parent_->formulae_.erase(cell_reference(column_, row_));
+        has_formula_ = false;
+    }
+}
+
+const std::string &cell_impl::hyperlink() const
+{
+    return parent_->hyperlinks_.at(cell_reference(column_, row_));
+}
+
+void cell_impl::hyperlink(const std::string &url)
+{
+    parent_->hyperlinks_[cell_reference(column_, row_)] = url;
+    has_hyperlink_ = true;
+}
+
+void cell_impl::clear_hyperlink()
+{
+    if (has_hyperlink_)
+    {
+        parent_->hyperlinks_.erase(cell_reference(column_, row_));
+        has_hyperlink_ = false;
+    }
+}
+
+xlnt::comment &cell_impl::comment()
+{
+    return parent_->comments_.at(cell_reference(column_, row_));
+}
+
+void cell_impl::comment(const xlnt::comment &new_comment)
+{
+    parent_->comments_[cell_reference(column_, row_)] = new_comment;
+    has_comment_ = true;
+}
+
+void cell_impl::clear_comment()
+{
+    if (has_comment_)
+    {
+        parent_->comments_.erase(cell_reference(column_, row_));
+        has_comment_ = false;
+    }
+}
+
+void cell_impl::clear_attributes()
+{
+    clear_value_text();
+    clear_formula();
+    clear_hyperlink();
+    clear_comment();
+}
+
+void cell_impl::copy_contents(const cell_impl &other)
+{
+    if (&other == this)
+    {
+        return;
+    }
+
+    type_ = other.type_;
+    value_numeric_ = other.value_numeric_;
+
+    // cells own a reference to their format, so the copy takes one of its own
+    if (other.format_ != nullptr)
+    {
+        ++other.format_->references;
+    }
+
+    if (format_ != nullptr)
+    {
+        format_->parent->release_format(*format_);
+    }
+
+    format_ = other.format_;
+
+    if (other.has_text_)
+    {
+        value_text(other.value_text());
+    }
+    else
+    {
+        clear_value_text();
+    }
+
+    if (other.has_formula_)
+    {
+        formula(other.formula());
+    }
+    else
+    {
+        clear_formula();
+    }
+
+    if (other.has_hyperlink_)
+    {
+        hyperlink(other.hyperlink());
+    }
+    else
+    {
+        clear_hyperlink();
+    }
+}
+
 } // namespace detail
 } // namespace xlnt
@@ -37,26 +37,112 @@ namespace detail {
 struct format_impl;
 struct worksheet_impl;
 
+/// <summary>
+/// The data stored for every cell. This is kept small since there is one
+/// per cell in a worksheet. Attributes that few cells have (formulae,
+/// hyperlinks, comments and the text of inline strings and errors) are
+/// stored in tables in the parent worksheet keyed by cell reference, with
+/// a flag here recording whether an entry exists.
+/// </summary>
 struct cell_impl
 {
     cell_impl();
 
-    cell_type type_;
+    /// <summary>
+    /// The value of a number or boolean cell or the index of a shared string.
+    /// </summary>
+    long double value_numeric_;
 
     worksheet_impl *parent_;
+    format_impl *format_;
 
     column_t column_;
     row_t row_;
 
-    bool is_merged_;
+    cell_type type_;
 
-    rich_text value_text_;
-    long double value_numeric_;
+    bool is_merged_ : 1;
+    bool has_text_ : 1;
+    bool has_formula_ : 1;
+    bool has_hyperlink_ : 1;
+    bool has_comment_ : 1;
+
+    /// <summary>
+    /// Changes the type of this cell's value, removing its text from the parent
+    /// worksheet's table unless the new type is one that has text.
+    /// </summary>
+    void type(cell_type new_type);
+
+    /// <summary>
+    /// Returns the text of an inline string, formula string or error cell.
+    /// </summary>
+    const rich_text &value_text() const;
+
+    /// <summary>
+    /// Sets the text of an inline string, formula string or error cell.
+    /// </summary>
+    void value_text(const rich_text &text);
+
+    /// <summary>
+    /// Removes the text set by value_text(text), if any.
+    /// </summary>
+    void clear_value_text();
+
+    /// <summary>
+    /// Returns the formula of this cell. has_formula_ must be true.
+    /// </summary>
+    const std::string &formula() const;
+
+    /// <summary>
+    /// Sets the formula of this cell.
+    /// </summary>
+    void formula(const std::string &formula);
+
+    /// <summary>
+    /// Removes the formula of this cell, if any.
+    /// </summary>
+    void clear_formula();
+
+    /// <summary>
+    /// Returns the hyperlink of this cell. has_hyperlink_ must be true.
+    /// </summary>
+    const std::string &hyperlink() const;
+
+    /// <summary>
+    /// Sets the hyperlink of this cell.
+    /// </summary>
+    void hyperlink(const std::string &url);
+
+    /// <summary>
+    /// Removes the hyperlink of this cell, if any.
+    /// </summary>
+    void clear_hyperlink();
+
+    /// <summary>
+    /// Returns the comment of this cell. has_comment_ must be true.
+    /// </summary>
+    xlnt::comment &comment();
+
+    /// <summary>
+    /// Sets the comment of this cell.
+    /// </summary>
+    void comment(const xlnt::comment &new_comment);
+
+    /// <summary>
+    /// Removes the comment of this cell, if any.
+    /// </summary>
+    void clear_comment();
+
+    /// <summary>
+    /// Removes every entry for this cell from the parent worksheet's tables.
+    /// </summary>
+    void clear_attributes();
 
-    optional<std::string> formula_;
-    optional<std::string> hyperlink_;
-    optional<format_impl *> format_;
-    optional<comment> comment_;
+    /// <summary>
+    /// Copies the value, format, formula and hyperlink of other to this cell
+    /// without changing its location.
+    /// </summary>
+    void copy_contents(const cell_impl &other);
 };
 
 } // namespace detail
@@ -0,0 +1,306 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <detail/implementations/cell_storage.hpp>
+
+namespace {
+
+// Chunks start small so that sparse worksheets stay small and double
+// in size up to this limit as more cells are added.
+const std::size_t first_chunk_size = 16;
+const std::size_t max_chunk_size = 4096;
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+cell_storage::cell_storage()
+    : chunk_capacity_(0),
+      chunk_used_(0),
+      size_(0),
+      cursor_(0),
+      lowest_column_(0),
+      highest_column_(0)
+{
+}
+
+cell_storage::cell_storage(const cell_storage &other)
+    : cell_storage()
+{
+    *this = other;
+}
+
+cell_storage &cell_storage::operator=(const cell_storage &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    clear();
+    reserve(other.size_);
+    rows_.reserve(other.rows_.size());
+
+    for (const auto &other_block : other.rows_)
+    {
+        rows_.push_back(row_block{other_block.row, {}});
+        auto &block = rows_.back();
+        block.cells.reserve(other_block.cells.size());
+
+        for (const auto &other_slot : other_block.cells)
+        {
+            auto impl = allocate();
+            *impl = *other_slot.impl;
+            block.cells.push_back(cell_slot{other_slot.column, impl});
+        }
+    }
+
+    size_ = other.size_;
+    lowest_column_ = other.lowest_column_;
+    highest_column_ = other.highest_column_;
+
+    return *this;
+}
+
+std::size_t cell_storage::size() const
+{
+    return size_;
+}
+
+bool cell_storage::empty() const
+{
+    return size_ == 0;
+}
+
+std::vector<cell_storage::row_block>::const_iterator cell_storage::lower_bound_row(row_t row) const
+{
+    // rows are usually accessed in order so check the last one first
+    if (rows_.empty() || rows_.back().row < row)
+    {
+        return rows_.end();
+    }
+
+    if (rows_.back().row == row)
+    {
+        return rows_.end() - 1;
+    }
+
+    // then the row last emplaced into and the one after it, which exists
+    // whenever the cursor precedes row since the back row follows row
+    if (cursor_ < rows_.size())
+    {
+        const auto cursor = rows_.begin() + static_cast<std::ptrdiff_t>(cursor_);
+
+        if (cursor->row == row)
+        {
+            return cursor;
+        }
+
+        if (cursor->row < row && (cursor + 1)->row >= row)
+        {
+            return cursor + 1;
+        }
+    }
+
+    return std::lower_bound(rows_.begin(), rows_.end(), row,
+        [](const row_block &block, row_t value) { return block.row < value; });
+}
+
+std::vector<cell_storage::cell_slot>::const_iterator cell_storage::lower_bound_column(
+    const row_block &block, column_t::index_t column)
+{
+    const auto &cells = block.cells;
+
+    if (cells.empty() || cells.back().column < column)
+    {
+        return cells.end();
+    }
+
+    // a row without gaps can be indexed directly
+    const auto first = cells.front().column;
+
+    if (column >= first && cells.back().column - first + 1 == cells.size())
+    {
+        return cells.begin() + (column - first);
+    }
+
+    return std::lower_bound(cells.begin(), cells.end(), column,
+        [](const cell_slot &slot, column_t::index_t value) { return slot.column < value; });
+}
+
+const cell_storage::row_block *cell_storage::find_row(row_t row) const
+{
+    auto block = lower_bound_row(row);
+
+    if (block == rows_.end() || block->row != row)
+    {
+        return nullptr;
+    }
+
+    return &*block;
+}
+
+cell_impl *cell_storage::find(row_t row, column_t::index_t column) const
+{
+    auto block = find_row(row);
+
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto slot = lower_bound_column(*block, column);
+
+    if (slot == block->cells.end() || slot->column != column)
+    {
+        return nullptr;
+    }
+
+    return slot->impl;
+}
+
+std::pair<cell_impl *, bool> cell_storage::emplace(row_t row, column_t::index_t column)
+{
+    auto block_position = lower_bound_row(row);
+
+    if (block_position == rows_.end() || block_position->row != row)
+    {
+        block_position = rows_.insert(block_position, row_block{row, {}});
+    }
+
+    cursor_ = static_cast<std::size_t>(block_position - rows_.begin());
+    auto &block = rows_[cursor_];
+    auto slot_position = lower_bound_column(block, column);
+
+    if (slot_position != block.cells.end() && slot_position->column == column)
+    {
+        return {slot_position->impl, false};
+    }
+
+    auto impl = allocate();
+    impl->row_ = row;
+    impl->column_ = column;
+    block.cells.insert(slot_position, cell_slot{column, impl});
+    ++size_;
+
+    lowest_column_ = lowest_column_ == 0 ? column : std::min(lowest_column_, column);
+    highest_column_ = std::max(highest_column_, column);
+
+    return {impl, true};
+}
+
+void cell_storage::reserve(std::size_t n)
+{
+    const auto available = free_.size() + chunk_capacity_ - chunk_used_;
+
+    if (n > size_ + available)
+    {
+        add_chunk(n - size_ - available);
+    }
+}
+
+void cell_storage::clear()
+{
+    rows_.clear();
+    chunks_.clear();
+    free_.clear();
+    chunk_capacity_ = 0;
+    chunk_used_ = 0;
+    size_ = 0;
+    cursor_ = 0;
+    lowest_column_ = 0;
+    highest_column_ = 0;
+}
+
+const std::vector<cell_storage::row_block> &cell_storage::rows() const
+{
+    return rows_;
+}
+
+column_t::index_t cell_storage::lowest_column() const
+{
+    return lowest_column_;
+}
+
+column_t::index_t cell_storage::highest_column() const
+{
+    return highest_column_;
+}
+
+void cell_storage::update_columns()
+{
+    lowest_column_ = 0;
+    highest_column_ = 0;
+
+    for (const auto &block : rows_)
+    {
+        if (lowest_column_ == 0 || block.cells.front().column < lowest_column_)
+        {
+            lowest_column_ = block.cells.front().column;
+        }
+
+        highest_column_ = std::max(highest_column_, block.cells.back().column);
+    }
+}
+
+cell_impl *cell_storage::allocate()
+{
+    if (!free_.empty())
+    {
+        auto impl = free_.back();
+        free_.pop_back();
+
+        return impl;
+    }
+
+    if (chunk_used_ == chunk_capacity_)
+    {
+        add_chunk(chunk_capacity_ == 0 ? first_chunk_size : std::min(chunk_capacity_ * 2, max_chunk_size));
+    }
+
+    return &chunks_.back()[chunk_used_++];
+}
+
+void cell_storage::release(cell_impl *impl)
+{
+    *impl = cell_impl();
+    free_.push_back(impl);
+    --size_;
+}
+
+void cell_storage::add_chunk(std::size_t n)
+{
+    // cells left over in the current chunk would otherwise be lost
+    while (chunk_used_ < chunk_capacity_)
+    {
+        free_.push_back(&chunks_.back()[chunk_used_++]);
+    }
+
+    chunks_.emplace_back(new cell_impl[n]);
+    chunk_capacity_ = n;
+    chunk_used_ = 0;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,234 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <detail/implementations/cell_impl.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Stores the cells of a worksheet as a vector of rows sorted by row index,
+/// each holding a vector of cells sorted by column index. Cells themselves
+/// are allocated in chunks so that pointers to them (held by xlnt::cell)
+/// remain valid while other cells are added or removed.
+/// </summary>
+class cell_storage
+{
+public:
+    /// <summary>
+    /// A cell in a row, stored with its column index so that searching a row
+    /// doesn't need to dereference every cell.
+    /// </summary>
+    struct cell_slot
+    {
+        column_t::index_t column;
+        cell_impl *impl;
+    };
+
+    /// <summary>
+    /// All of the cells in a single row, sorted by column.
+    /// </summary>
+    struct row_block
+    {
+        row_t row;
+        std::vector<cell_slot> cells;
+    };
+
+    cell_storage();
+
+    cell_storage(const cell_storage &other);
+
+    cell_storage &operator=(const cell_storage &other);
+
+    /// <summary>
+    /// Returns the number of cells.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns true if there are no cells.
+    /// </summary>
+    bool empty() const;
+
+    /// <summary>
+    /// Returns the cell at the given location or nullptr if it doesn't exist.
+    /// </summary>
+    cell_impl *find(row_t row, column_t::index_t column) const;
+
+    /// <summary>
+    /// Returns the row block with the given index or nullptr if the row has no cells.
+    /// </summary>
+    const row_block *find_row(row_t row) const;
+
+    /// <summary>
+    /// Returns the cell at the given location, creating it first if it doesn't
+    /// exist. The second element of the result is true if the cell was created.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(row_t row, column_t::index_t column);
+
+    /// <summary>
+    /// Removes every cell for which predicate returns true along with any
+    /// rows left empty as a result.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        for (auto &block : rows_)
+        {
+            auto first_removed = std::remove_if(block.cells.begin(), block.cells.end(),
+                [&](const cell_slot &slot) {
+                    if (!predicate(*slot.impl)) return false;
+                    release(slot.impl);
+                    return true;
+                });
+
+            block.cells.erase(first_removed, block.cells.end());
+        }
+
+        rows_.erase(std::remove_if(rows_.begin(), rows_.end(),
+            [](const row_block &block) { return block.cells.empty(); }), rows_.end());
+
+        update_columns();
+    }
+
+    /// <summary>
+    /// Ensures that at least n cells can be created without further allocation
+    /// of cell storage.
+    /// </summary>
+    void reserve(std::size_t n);
+
+    /// <summary>
+    /// Removes all cells.
+    /// </summary>
+    void clear();
+
+    /// <summary>
+    /// Returns all non-empty rows in ascending order.
+    /// </summary>
+    const std::vector<row_block> &rows() const;
+
+    /// <summary>
+    /// Returns the lowest column index of any cell or 0 if there are no cells.
+    /// </summary>
+    column_t::index_t lowest_column() const;
+
+    /// <summary>
+    /// Returns the highest column index of any cell or 0 if there are no cells.
+    /// </summary>
+    column_t::index_t highest_column() const;
+
+private:
+    /// <summary>
+    /// Returns the first row with an index not less than row.
+    /// </summary>
+    std::vector<row_block>::const_iterator lower_bound_row(row_t row) const;
+
+    /// <summary>
+    /// Returns the first cell in block with a column index not less than column.
+    /// </summary>
+    static std::vector<cell_slot>::const_iterator lower_bound_column(
+        const row_block &block, column_t::index_t column);
+
+    /// <summary>
+    /// Recalculates lowest_column_ and highest_column_ from every row after
+    /// cells have been removed.
+    /// </summary>
+    void update_columns();
+
+    /// <summary>
+    /// Returns an unused default-constructed cell.
+    /// </summary>
+    cell_impl *allocate();
+
+    /// <summary>
+    /// Resets impl and makes it available to allocate again.
+    /// </summary>
+    void release(cell_impl *impl);
+
+    /// <summary>
+    /// Adds a chunk of at least n cells to the pool.
+    /// </summary>
+    void add_chunk(std::size_t n);
+
+    /// <summary>
+    /// The non-empty rows, sorted by row index.
+    /// </summary>
+    std::vector<row_block> rows_;
+
+    /// <summary>
+    /// The blocks of memory that cells are allocated from.
+    /// </summary>
+    std::vector<std::unique_ptr<cell_impl[]>> chunks_;
+
+    /// <summary>
+    /// The number of cells in the last chunk.
+    /// </summary>
+    std::size_t chunk_capacity_;
+
+    /// <summary>
+    /// The number of cells in the last chunk that have been handed out.
+    /// </summary>
+    std::size_t chunk_used_;
+
+    /// <summary>
+    /// Released cells which can be reused before taking new ones from a chunk.
+    /// </summary>
+    std::vector<cell_impl *> free_;
+
+    /// <summary>
+    /// The number of cells currently stored.
+    /// </summary>
+    std::size_t size_;
+
+    /// <summary>
+    /// The index in rows_ of the row that a cell was last emplaced in. Rows are
+    /// usually visited in order so this row or the next one is checked before
+    /// searching. It may be stale after rows are inserted or removed, which
+    /// only makes that check miss.
+    /// </summary>
+    std::size_t cursor_;
+
+    /// <summary>
+    /// The lowest column index of any cell or 0 if there are no cells. This is
+    /// updated as cells are added so that finding the dimension of a worksheet
+    /// doesn't need to visit every row.
+    /// </summary>
+    column_t::index_t lowest_column_;
+
+    /// <summary>
+    /// The highest column index of any cell or 0 if there are no cells.
+    /// </summary>
+    column_t::index_t highest_column_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,218 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <functional>
+#include <string>
+
+#include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/style_hash.hpp>
+#include <xlnt/styles/alignment.hpp>
+#include <xlnt/styles/border.hpp>
+#include <xlnt/styles/color.hpp>
+#include <xlnt/styles/fill.hpp>
+#include <xlnt/styles/font.hpp>
+#include <xlnt/styles/number_format.hpp>
+#include <xlnt/styles/protection.hpp>
+
+namespace {
+
+void combine(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template <typename T>
+void combine_enum(std::size_t &seed, T value)
+{
+    combine(seed, static_cast<std::size_t>(value));
+}
+
+void combine_double(std::size_t &seed, double value)
+{
+    static const std::hash<double> hasher;
+    combine(seed, hasher(value));
+}
+
+template <typename T>
+void combine_optional_enum(std::size_t &seed, const xlnt::optional<T> &value)
+{
+    combine(seed, value.is_set() ? static_cast<std::size_t>(value.get()) + 1 : 0);
+}
+
+void combine_optional_color(std::size_t &seed, const xlnt::optional<xlnt::color> &value)
+{
+    combine(seed, value.is_set() ? xlnt::detail::style_hash(value.get()) : 0);
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::size_t style_hash(const alignment &item)
+{
+    std::size_t seed = 0;
+
+    combine_optional_enum(seed, item.horizontal());
+    combine_optional_enum(seed, item.vertical());
+    combine_optional_enum(seed, item.indent());
+    combine_optional_enum(seed, item.rotation());
+    combine(seed, item.wrap());
+    combine(seed, item.shrink());
+
+    return seed;
+}
+
+std::size_t style_hash(const border &item)
+{
+    std::size_t seed = 0;
+
+    for (auto side : border::all_sides())
+    {
+        const auto property = item.side(side);
+        combine(seed, property.is_set());
+
+        if (property.is_set())
+        {
+            combine_optional_enum(seed, property.get().style());
+            combine_optional_color(seed, property.get().color());
+        }
+    }
+
+    return seed;
+}
+
+std::size_t style_hash(const color &item)
+{
+    std::size_t seed = 0;
+
+    combine_enum(seed, item.type());
+    combine(seed, item.auto_());
+    combine_double(seed, item.tint());
+
+    switch (item.type())
+    {
+    case color_type::indexed:
+        combine(seed, item.indexed().index());
+        break;
+    case color_type::theme:
+        combine(seed, item.theme().index());
+        break;
+    case color_type::rgb:
+    {
+        const auto rgba = item.rgb().rgba();
+        combine(seed, static_cast<std::size_t>(rgba[0]) << 24 | static_cast<std::size_t>(rgba[1]) << 16
+                | static_cast<std::size_t>(rgba[2]) << 8 | rgba[3]);
+        break;
+    }
+    }
+
+    return seed;
+}
+
+std::size_t style_hash(const fill &item)
+{
+    std::size_t seed = 0;
+
+    combine_enum(seed, item.type());
+
+    if (item.type() == fill_type::gradient)
+    {
+        const auto gradient = item.gradient_fill();
+        combine_enum(seed, gradient.type());
+        combine_double(seed, gradient.degree());
+    }
+    else
+    {
+        const auto pattern = item.pattern_fill();
+        combine_enum(seed, pattern.type());
+        combine_optional_color(seed, pattern.foreground());
+        combine_optional_color(seed, pattern.background());
+    }
+
+    return seed;
+}
+
+std::size_t style_hash(const font &item)
+{
+    static const std::hash<std::string> string_hasher;
+    std::size_t seed = 0;
+
+    combine(seed, item.has_name() ? string_hasher(item.name()) : 0);
+
+    if (item.has_size())
+    {
+        combine_double(seed, item.size());
+    }
+
+    combine(seed, item.bold());
+    combine(seed, item.italic());
+    combine(seed, item.strikethrough());
+    combine(seed, item.superscript());
+    combine_enum(seed, item.underline());
+
+    if (item.has_color())
+    {
+        combine(seed, style_hash(item.color()));
+    }
+
+    return seed;
+}
+
+std::size_t style_hash(const format_impl &item)
+{
+    static const std::hash<std::string> string_hasher;
+    std::size_t seed = 0;
+
+    combine_optional_enum(seed, item.alignment_id);
+    combine_optional_enum(seed, item.border_id);
+    combine_optional_enum(seed, item.fill_id);
+    combine_optional_enum(seed, item.font_id);
+    combine_optional_enum(seed, item.number_format_id);
+    combine_optional_enum(seed, item.protection_id);
+
+    combine(seed, static_cast<std::size_t>(item.alignment_applied) | static_cast<std::size_t>(item.border_applied) << 1
+            | static_cast<std::size_t>(item.fill_applied) << 2 | static_cast<std::size_t>(item.font_applied) << 3
+            | static_cast<std::size_t>(item.number_format_applied) << 4
+            | static_cast<std::size_t>(item.protection_applied) << 5
+            | static_cast<std::size_t>(item.pivot_button_) << 6 | static_cast<std::size_t>(item.quote_prefix_) << 7);
+
+    combine(seed, item.style.is_set() ? string_hasher(item.style.get()) : 0);
+
+    return seed;
+}
+
+std::size_t style_hash(const number_format &item)
+{
+    static const std::hash<std::string> hasher;
+    return hasher(item.format_string());
+}
+
+std::size_t style_hash(const protection &item)
+{
+    return static_cast<std::size_t>(item.locked()) | static_cast<std::size_t>(item.hidden()) << 1;
+}
+
+} // namespace detail
+} // namespace xlnt
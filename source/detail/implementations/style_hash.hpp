@@ -0,0 +1,58 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class alignment;
+class border;
+class color;
+class fill;
+class font;
+class number_format;
+class protection;
+
+namespace detail {
+
+struct format_impl;
+
+// Hashes of the items stored in a stylesheet. Only properties that are
+// compared by the item's operator== are hashed, so equal items always
+// have equal hashes.
+
+std::size_t style_hash(const alignment &item);
+std::size_t style_hash(const border &item);
+std::size_t style_hash(const color &item);
+std::size_t style_hash(const fill &item);
+std::size_t style_hash(const font &item);
+std::size_t style_hash(const format_impl &item);
+std::size_t style_hash(const number_format &item);
+std::size_t style_hash(const protection &item);
+
+} // namespace detail
+} // namespace xlnt
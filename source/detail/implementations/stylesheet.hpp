@@ -23,12 +23,17 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <detail/implementations/conditional_format_impl.hpp>
 #include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/style_hash.hpp>
 #include <detail/implementations/style_impl.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/conditional_format.hpp>
@@ -42,6 +47,228 @@
 namespace xlnt {
 namespace detail {
 
+/// <summary>
+/// Owns the formats of a stylesheet in id order. Each format is allocated
+/// separately so that the pointers held by cells stay valid as formats are
+/// added and removed while still allowing constant time access by id.
+/// Copies are deep.
+/// </summary>
+class format_impl_vector
+{
+    using container = std::vector<std::unique_ptr<format_impl>>;
+
+    template <typename Value, typename Iterator>
+    class iterator_base
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = format_impl;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        explicit iterator_base(Iterator iter)
+            : iter_(iter)
+        {
+        }
+
+        reference operator*() const
+        {
+            return **iter_;
+        }
+
+        pointer operator->() const
+        {
+            return iter_->get();
+        }
+
+        iterator_base &operator++()
+        {
+            ++iter_;
+            return *this;
+        }
+
+        bool operator==(const iterator_base &other) const
+        {
+            return iter_ == other.iter_;
+        }
+
+        bool operator!=(const iterator_base &other) const
+        {
+            return iter_ != other.iter_;
+        }
+
+    private:
+        Iterator iter_;
+    };
+
+public:
+    using iterator = iterator_base<format_impl, container::iterator>;
+    using const_iterator = iterator_base<const format_impl, container::const_iterator>;
+
+    format_impl_vector() = default;
+    format_impl_vector(format_impl_vector &&other) = default;
+    format_impl_vector &operator=(format_impl_vector &&other) = default;
+
+    format_impl_vector(const format_impl_vector &other)
+    {
+        *this = other;
+    }
+
+    format_impl_vector &operator=(const format_impl_vector &other)
+    {
+        if (this == &other) return *this;
+
+        formats_.clear();
+        formats_.reserve(other.formats_.size());
+
+        for (const auto &format : other.formats_)
+        {
+            formats_.emplace_back(new format_impl(*format));
+        }
+
+        return *this;
+    }
+
+    format_impl &operator[](std::size_t index)
+    {
+        return *formats_[index];
+    }
+
+    const format_impl &operator[](std::size_t index) const
+    {
+        return *formats_[index];
+    }
+
+    format_impl &at(std::size_t index)
+    {
+        return *formats_.at(index);
+    }
+
+    format_impl &back()
+    {
+        return *formats_.back();
+    }
+
+    void push_back(const format_impl &format)
+    {
+        formats_.emplace_back(new format_impl(format));
+    }
+
+    /// <summary>
+    /// Removes every format for which predicate returns true.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        formats_.erase(std::remove_if(formats_.begin(), formats_.end(),
+                           [&predicate](const std::unique_ptr<format_impl> &format) { return predicate(*format); }),
+            formats_.end());
+    }
+
+    std::size_t size() const
+    {
+        return formats_.size();
+    }
+
+    bool empty() const
+    {
+        return formats_.empty();
+    }
+
+    void clear()
+    {
+        formats_.clear();
+    }
+
+    iterator begin()
+    {
+        return iterator(formats_.begin());
+    }
+
+    iterator end()
+    {
+        return iterator(formats_.end());
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(formats_.begin());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(formats_.end());
+    }
+
+private:
+    container formats_;
+};
+
+/// <summary>
+/// Maps the hash of each item in one of the tables of a stylesheet to its
+/// index so that equal items can be found without comparing against the
+/// whole table. The tables are also appended to directly, for example while
+/// reading a file, so items appended since the last lookup are indexed
+/// before each lookup and the index is rebuilt if the table shrank. Anything
+/// that changes an item in place must clear the index of its table, since the
+/// item would otherwise stay filed under its old hash and equal items added
+/// later wouldn't find it.
+/// </summary>
+class interning_index
+{
+public:
+    /// <summary>
+    /// Returns the index of the first item in container equal to item
+    /// or container.size() if there is none.
+    /// </summary>
+    template <typename C, typename T>
+    std::size_t find(const C &container, const T &item)
+    {
+        catch_up(container);
+
+        auto range = ids_.equal_range(style_hash(item));
+        auto result = container.size();
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second < result && container[iter->second] == item)
+            {
+                result = iter->second;
+            }
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Discards the index so that it is rebuilt by the next lookup.
+    /// </summary>
+    void clear()
+    {
+        ids_.clear();
+        indexed_ = 0;
+    }
+
+private:
+    template <typename C>
+    void catch_up(const C &container)
+    {
+        if (container.size() < indexed_)
+        {
+            clear();
+        }
+
+        for (; indexed_ < container.size(); ++indexed_)
+        {
+            ids_.emplace(style_hash(container[indexed_]), indexed_);
+        }
+    }
+
+    std::unordered_multimap<std::size_t, std::size_t> ids_;
+    std::size_t indexed_ = 0;
+};
+
 struct stylesheet
 {
     class format create_format(bool default_format)
@@ -58,16 +285,14 @@ struct stylesheet
         impl.number_format_id = 0;
         
         impl.references = default_format ? 1 : 0;
+        garbage_collection_needed = garbage_collection_needed || !default_format;
         
         return xlnt::format(&impl);
     }
 
     class xlnt::format format(std::size_t index)
     {
-        auto iter = format_impls.begin();
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
-
-        return xlnt::format(&*iter);
+        return xlnt::format(&format_impls.at(index));
     }
 
     class style create_style(const std::string &name)
@@ -177,253 +402,244 @@ struct stylesheet
 		return id;
 	}
     
+    interning_index &index_of(const std::vector<alignment> &)
+    {
+        return alignment_index;
+    }
+
+    interning_index &index_of(const std::vector<border> &)
+    {
+        return border_index;
+    }
+
+    interning_index &index_of(const std::vector<fill> &)
+    {
+        return fill_index;
+    }
+
+    interning_index &index_of(const std::vector<font> &)
+    {
+        return font_index;
+    }
+
+    interning_index &index_of(const std::vector<number_format> &)
+    {
+        return number_format_index;
+    }
+
+    interning_index &index_of(const std::vector<protection> &)
+    {
+        return protection_index;
+    }
+
     template<typename T, typename C>
     std::size_t find_or_add(C &container, const T &item, bool *added = nullptr)
     {
+        const auto id = index_of(container).find(container, item);
+        const auto found = id < container.size();
+
         if (added != nullptr)
         {
-            *added = false;
+            *added = !found;
         }
 
-        std::size_t i = 0;
-        
-        for (auto iter = container.begin(); iter != container.end(); ++iter)
+        if (!found)
         {
-            if (*iter == item)
-            {
-                return i;
-            }
-
-            ++i;
+            container.emplace(container.end(), item);
         }
 
-        if (added != nullptr)
+        return id;
+    }
+
+    void clear_indices()
+    {
+        alignment_index.clear();
+        border_index.clear();
+        fill_index.clear();
+        font_index.clear();
+        number_format_index.clear();
+        protection_index.clear();
+        format_index.clear();
+    }
+    
+    /// <summary>
+    /// Increments the count for id if it is set.
+    /// </summary>
+    static void count_reference(const optional<std::size_t> &id, std::vector<std::size_t> &counts)
+    {
+        if (id.is_set() && id.get() < counts.size())
         {
-            *added = true;
+            ++counts[id.get()];
         }
+    }
 
-        container.emplace(container.end(), item);
-
-        return container.size() - 1;
+    /// <summary>
+    /// Replaces id with its new value if it is set.
+    /// </summary>
+    static void remap_reference(optional<std::size_t> &id, const std::vector<std::size_t> &new_ids)
+    {
+        if (id.is_set() && id.get() < new_ids.size())
+        {
+            id = new_ids[id.get()];
+        }
     }
-    
+
+    /// <summary>
+    /// Removes the items of container with no references, keeping the others in
+    /// order, and returns the new index of each original item.
+    /// </summary>
     template<typename T>
-    std::unordered_map<std::size_t, std::size_t> garbage_collect(
-        const std::unordered_map<std::size_t, std::size_t> &reference_counts,
-        std::vector<T> &container)
+    static std::vector<std::size_t> compact(std::vector<T> &container, const std::vector<std::size_t> &counts)
     {
-        std::unordered_map<std::size_t, std::size_t> id_map;
-        std::size_t unreferenced = 0;
-        const auto original_size = container.size();
+        std::vector<std::size_t> new_ids(container.size());
+        std::size_t kept = 0;
 
-        for (std::size_t i = 0; i < original_size; ++i)
+        for (std::size_t i = 0; i < container.size(); ++i)
         {
-            id_map[i] = i - unreferenced;
+            new_ids[i] = kept;
 
-            if (reference_counts.count(i) == 0 || reference_counts.at(i) == 0)
+            if (counts[i] == 0) continue;
+
+            if (kept != i)
             {
-                container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(i - unreferenced));
-                unreferenced++;
+                container[kept] = std::move(container[i]);
             }
+
+            ++kept;
         }
 
-        return id_map;
+        container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(kept), container.end());
+
+        return new_ids;
     }
-    
+
+    /// <summary>
+    /// Removes formats that no cell uses and then any alignment, border, fill,
+    /// font or protection that no remaining format, style or conditional format
+    /// uses. Everything that remains is renumbered in a single pass. This does
+    /// nothing unless a format may have become unused since the last collection.
+    /// </summary>
     void garbage_collect()
     {
-        if (!garbage_collection_enabled) return;
-        
-        auto format_iter = format_impls.begin();
+        if (!garbage_collection_needed) return;
 
-        while (format_iter != format_impls.end())
-        {
-            auto &impl = *format_iter;
+        garbage_collection_needed = false;
 
-            if (impl.references != 0)
-            {
-                ++format_iter;
-            }
-            else
-            {
-                format_iter = format_impls.erase(format_iter);
-            }
+        format_impls.erase_if([](const format_impl &impl) { return impl.references == 0; });
+
+        std::vector<std::size_t> alignment_counts(alignments.size());
+        std::vector<std::size_t> border_counts(borders.size());
+        std::vector<std::size_t> fill_counts(fills.size());
+        std::vector<std::size_t> font_counts(fonts.size());
+        std::vector<std::size_t> protection_counts(protections.size());
+
+        // the first two fills are reserved
+        for (std::size_t i = 0; i < fill_counts.size() && i < 2; ++i)
+        {
+            ++fill_counts[i];
         }
-        
+
+        auto count_references = [&](const auto &impl) {
+            count_reference(impl.alignment_id, alignment_counts);
+            count_reference(impl.border_id, border_counts);
+            count_reference(impl.fill_id, fill_counts);
+            count_reference(impl.font_id, font_counts);
+            count_reference(impl.protection_id, protection_counts);
+        };
+
         std::size_t new_id = 0;
 
-        std::unordered_map<std::size_t, std::size_t> alignment_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> border_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> fill_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> font_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> number_format_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> protection_reference_counts;
-        
-        fill_reference_counts[0]++;
-        fill_reference_counts[1]++;
-        
         for (auto &impl : format_impls)
         {
             impl.id = new_id++;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                protection_reference_counts[impl.protection_id.get()]++;
-            }
+            count_references(impl);
         }
-        
-        for (auto &name_impl_pair : style_impls)
+
+        for (const auto &name_impl_pair : style_impls)
         {
-            auto &impl = name_impl_pair.second;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                protection_reference_counts[impl.protection_id.get()]++;
-            }
+            count_references(name_impl_pair.second);
         }
-        
-        auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
-        auto border_id_map = garbage_collect(border_reference_counts, borders);
-        auto fill_id_map = garbage_collect(fill_reference_counts, fills);
-        auto font_id_map = garbage_collect(font_reference_counts, fonts);
-        auto protection_id_map = garbage_collect(protection_reference_counts, protections);
+
+        for (const auto &impl : conditional_format_impls)
+        {
+            count_reference(impl.border_id, border_counts);
+            count_reference(impl.fill_id, fill_counts);
+            count_reference(impl.font_id, font_counts);
+        }
+
+        const auto alignment_ids = compact(alignments, alignment_counts);
+        const auto border_ids = compact(borders, border_counts);
+        const auto fill_ids = compact(fills, fill_counts);
+        const auto font_ids = compact(fonts, font_counts);
+        const auto protection_ids = compact(protections, protection_counts);
+
+        auto remap_references = [&](auto &impl) {
+            remap_reference(impl.alignment_id, alignment_ids);
+            remap_reference(impl.border_id, border_ids);
+            remap_reference(impl.fill_id, fill_ids);
+            remap_reference(impl.font_id, font_ids);
+            remap_reference(impl.protection_id, protection_ids);
+        };
 
         for (auto &impl : format_impls)
         {
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                impl.font_id = font_id_map[impl.font_id.get()];
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
-            }
+            remap_references(impl);
         }
 
-        for (auto &name_impl : style_impls)
+        for (auto &name_impl_pair : style_impls)
         {
-            auto &impl = name_impl.second;
+            remap_references(name_impl_pair.second);
+        }
 
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                impl.font_id = font_id_map[impl.font_id.get()];
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
-            }
+        for (auto &impl : conditional_format_impls)
+        {
+            remap_reference(impl.border_id, border_ids);
+            remap_reference(impl.fill_id, fill_ids);
+            remap_reference(impl.font_id, font_ids);
         }
+
+        clear_indices();
     }
 
     format_impl *find_or_create(format_impl &pattern)
     {
-        auto iter = format_impls.begin();
-        bool added = false;
-        auto id = find_or_add(format_impls, pattern, &added);
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(id));
-        
-        auto &result = *iter;
+        const auto id = format_index.find(format_impls, pattern);
+        const auto added = id == format_impls.size();
 
         if (added)
         {
+            format_impls.push_back(pattern);
+        }
+
+        auto &result = format_impls[id];
+
+        if (added)
+        {
+            // references are counted by the cells that use the format
             result.references = 0;
+            garbage_collection_needed = true;
         }
 
         result.parent = this;
         result.id = id;
-        result.references++;
-        
-        if (id != pattern.id)
-        {
-            pattern.references -= pattern.references > 0 ? 1 : 0;
-            garbage_collect();
-        }
 
         return &result;
     }
 
+    /// <summary>
+    /// Records that count fewer cells use format so that it can be removed by
+    /// the next garbage collection if no cells use it anymore.
+    /// </summary>
+    void release_format(format_impl &format, std::size_t count = 1)
+    {
+        format.references -= std::min(format.references, count);
+
+        if (format.references == 0)
+        {
+            garbage_collection_needed = true;
+        }
+    }
+
     format_impl *find_or_create_with(format_impl *pattern, const std::string &style_name)
     {
         format_impl new_format = *pattern;
@@ -500,6 +716,7 @@ struct stylesheet
     {
 		conditional_format_impls.clear();
         format_impls.clear();
+        clear_indices();
         
         style_impls.clear();
         style_names.clear();
@@ -530,10 +747,13 @@ struct stylesheet
 
     workbook *parent;
     
-    bool garbage_collection_enabled = false;
+    /// <summary>
+    /// True if a format may have become unused since the last call to garbage_collect.
+    /// </summary>
+    bool garbage_collection_needed = false;
 
 	std::list<conditional_format_impl> conditional_format_impls;
-    std::list<format_impl> format_impls;
+    format_impl_vector format_impls;
     std::unordered_map<std::string, style_impl> style_impls;
     std::vector<std::string> style_names;
 
@@ -545,6 +765,14 @@ struct stylesheet
 	std::vector<protection> protections;
     
     std::vector<color> colors;
+
+    interning_index alignment_index;
+    interning_index border_index;
+    interning_index fill_index;
+    interning_index font_index;
+    interning_index number_format_index;
+    interning_index protection_index;
+    interning_index format_index;
 };
 
 } // namespace detail
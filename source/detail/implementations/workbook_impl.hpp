@@ -23,6 +23,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -42,6 +43,7 @@
 namespace xlnt {
 namespace detail {
 
+class xlsx_consumer;
 struct worksheet_impl;
 
 struct workbook_impl
@@ -54,6 +56,7 @@ struct workbook_impl
         : active_sheet_index_(other.active_sheet_index_),
           worksheets_(other.worksheets_),
           shared_strings_(other.shared_strings_),
+          shared_string_ids_(other.shared_string_ids_),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -73,6 +76,7 @@ struct workbook_impl
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
         shared_strings_.clear();
         std::copy(other.shared_strings_.begin(), other.shared_strings_.end(), std::back_inserter(shared_strings_));
+        shared_string_ids_ = other.shared_string_ids_;
 		theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -93,6 +97,13 @@ struct workbook_impl
     std::list<worksheet_impl> worksheets_;
     std::vector<rich_text> shared_strings_;
 
+    /// <summary>
+    /// Maps the hash of each string in shared_strings_ to its index so that
+    /// add_shared_string doesn't need to search the whole table. Entries
+    /// with the same hash are disambiguated by comparing the strings.
+    /// </summary>
+    std::unordered_multimap<std::size_t, std::size_t> shared_string_ids_;
+
     optional<stylesheet> stylesheet_;
 
     calendar base_date_;
@@ -121,6 +132,12 @@ struct workbook_impl
     
     optional<file_version_t> file_version_;
     optional<calculation_properties> calculation_properties_;
+
+    /// <summary>
+    /// The consumer holding worksheets that were loaded lazily and haven't
+    /// been read yet. It isn't copied since copies read every worksheet first.
+    /// </summary>
+    std::shared_ptr<xlsx_consumer> worksheet_reader_;
 };
 
 } // namespace detail
@@ -28,6 +28,10 @@
 #include <vector>
 
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_storage.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/cell/comment.hpp>
+#include <xlnt/cell/rich_text.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/worksheet/range.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
@@ -64,13 +68,17 @@ struct worksheet_impl
         title_ = other.title_;
         column_properties_ = other.column_properties_;
         row_properties_ = other.row_properties_;
-        cell_map_ = other.cell_map_;
+        cells_ = other.cells_;
+        cell_text_ = other.cell_text_;
+        formulae_ = other.formulae_;
+        hyperlinks_ = other.hyperlinks_;
+        comments_ = other.comments_;
 
-        for (auto &row : cell_map_)
+        for (auto &row : cells_.rows())
         {
-            for (auto &cell : row.second)
+            for (auto &cell : row.cells)
             {
-                cell.second.parent_ = this;
+                cell.impl->parent_ = this;
             }
         }
 
@@ -96,7 +104,13 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<row_t, std::unordered_map<column_t, cell_impl>> cell_map_;
+    cell_storage cells_;
+
+    // attributes that most cells don't have, see cell_impl
+    std::unordered_map<cell_reference, rich_text, cell_reference_hash> cell_text_;
+    std::unordered_map<cell_reference, std::string, cell_reference_hash> formulae_;
+    std::unordered_map<cell_reference, std::string, cell_reference_hash> hyperlinks_;
+    std::unordered_map<cell_reference, comment, cell_reference_hash> comments_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
@@ -0,0 +1,660 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <detail/number_chars.hpp>
+
+namespace {
+
+/// <summary>
+/// The number of significant decimal digits that always fit in the 64-bit
+/// mantissa accumulated by parse_number.
+/// </summary>
+const int max_mantissa_digits = 19;
+
+/// <summary>
+/// Returns 10 to the power of exponent, which must be at most max_exact_power().
+/// </summary>
+long double power_of_ten(int exponent)
+{
+    static const long double powers[] = {1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L,
+        1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L,
+        1e25L, 1e26L, 1e27L};
+
+    return powers[exponent];
+}
+
+/// <summary>
+/// Returns the largest power of ten that a long double holds exactly. 5^27 is
+/// the largest power of five below 2^64 and 5^22 the largest below 2^53.
+/// </summary>
+int max_exact_power()
+{
+    return std::numeric_limits<long double>::digits >= 64 ? 27 : 22;
+}
+
+/// <summary>
+/// Returns true if mantissa can be converted to a long double exactly.
+/// </summary>
+bool exact_mantissa(std::uint64_t mantissa)
+{
+    const auto digits = std::numeric_limits<long double>::digits;
+    return digits >= 64 || mantissa <= (std::uint64_t(1) << digits);
+}
+
+bool is_digit(char character)
+{
+    return character >= '0' && character <= '9';
+}
+
+/// <summary>
+/// Parses numbers that the fast path can't convert exactly, such as those with
+/// more than 19 significant digits, with std::strtold. The only way strtold
+/// depends on the locale is its decimal point, so that replaces '.' in the copy
+/// of the text that's parsed.
+/// </summary>
+bool parse_number_slow(const char *first, const char *last, long double &value)
+{
+    const auto decimal_point = std::localeconv()->decimal_point;
+
+    // numbers as long as this are only written by hand, so they needn't avoid allocation
+    char buffer[64];
+    std::string long_text;
+    auto text = buffer;
+    auto length = std::size_t(0);
+
+    if (static_cast<std::size_t>(last - first) + std::strlen(decimal_point) >= sizeof(buffer))
+    {
+        long_text.resize(static_cast<std::size_t>(last - first) * (std::strlen(decimal_point) + 1) + 1);
+        text = &long_text[0];
+    }
+
+    for (auto position = first; position != last; ++position)
+    {
+        if (*position == '.')
+        {
+            for (auto decimal_character = decimal_point; *decimal_character != '\0'; ++decimal_character)
+            {
+                text[length++] = *decimal_character;
+            }
+        }
+        else
+        {
+            text[length++] = *position;
+        }
+    }
+
+    text[length] = '\0';
+
+    char *end = nullptr;
+    errno = 0;
+    const auto parsed = std::strtold(text, &end);
+
+    if (end != text + length || (errno == ERANGE && std::isinf(parsed)))
+    {
+        return false;
+    }
+
+    value = parsed;
+
+    return true;
+}
+
+/// <summary>
+/// A floating point number f * 2^e with a 64-bit significand, as used by
+/// Grisu2 to find the shortest digits of a double. See Loitsch, "Printing
+/// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010.
+/// </summary>
+struct diy_fp
+{
+    std::uint64_t f;
+    int e;
+};
+
+/// <summary>
+/// Returns x - y where both have the same exponent and x.f >= y.f.
+/// </summary>
+diy_fp subtract(diy_fp x, diy_fp y)
+{
+    return {x.f - y.f, x.e};
+}
+
+/// <summary>
+/// Returns the upper 64 bits of the product of x and y, rounded.
+/// </summary>
+diy_fp multiply(diy_fp x, diy_fp y)
+{
+    const auto x_low = x.f & 0xFFFFFFFFu;
+    const auto x_high = x.f >> 32;
+    const auto y_low = y.f & 0xFFFFFFFFu;
+    const auto y_high = y.f >> 32;
+
+    const auto low_low = x_low * y_low;
+    const auto low_high = x_low * y_high;
+    const auto high_low = x_high * y_low;
+    const auto high_high = x_high * y_high;
+
+    auto middle = (low_low >> 32) + (low_high & 0xFFFFFFFFu) + (high_low & 0xFFFFFFFFu);
+    middle += std::uint64_t(1) << 31;
+
+    return {high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32), x.e + y.e + 64};
+}
+
+diy_fp normalize(diy_fp x)
+{
+    while ((x.f >> 63) == 0)
+    {
+        x.f <<= 1;
+        --x.e;
+    }
+
+    return x;
+}
+
+/// <summary>
+/// The value of a double and the boundaries halfway to its neighbours, all
+/// normalized to the exponent of the upper boundary.
+/// </summary>
+struct boundaries
+{
+    diy_fp w;
+    diy_fp minus;
+    diy_fp plus;
+};
+
+boundaries compute_boundaries(double value)
+{
+    const auto significand_bits = 52;
+    const auto exponent_bias = 1075;
+    const auto hidden_bit = std::uint64_t(1) << significand_bits;
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const auto biased_exponent = static_cast<int>((bits >> significand_bits) & 0x7FF);
+    const auto fraction = bits & (hidden_bit - 1);
+
+    const auto v = biased_exponent == 0
+        ? diy_fp{fraction, 1 - exponent_bias}
+        : diy_fp{fraction + hidden_bit, biased_exponent - exponent_bias};
+
+    // the gap to the next lower double is half as wide at a power of two
+    const auto lower_is_closer = fraction == 0 && biased_exponent > 1;
+    const auto plus = normalize(diy_fp{2 * v.f + 1, v.e - 1});
+    auto minus = lower_is_closer ? diy_fp{4 * v.f - 1, v.e - 2} : diy_fp{2 * v.f - 1, v.e - 1};
+
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    return {normalize(v), minus, plus};
+}
+
+/// <summary>
+/// A normalized approximation of 10^k as f * 2^e.
+/// </summary>
+struct cached_power
+{
+    std::uint64_t f;
+    int e;
+    int k;
+};
+
+// The binary exponent of a scaled value is kept in this range so that its
+// integral part fits in 32 bits.
+const int min_scaled_exponent = -60;
+const int max_scaled_exponent = -32;
+
+/// <summary>
+/// Returns a power of ten c such that w * c, for a normalized w with the given
+/// binary exponent, has a binary exponent within [-60, -32].
+/// </summary>
+cached_power cached_power_for(int binary_exponent)
+{
+    static const cached_power powers[] = {
+        {0xAB70FE17C79AC6CA, -1060, -300},
+        {0xFF77B1FCBEBCDC4F, -1034, -292},
+        {0xBE5691EF416BD60C, -1007, -284},
+        {0x8DD01FAD907FFC3C, -980, -276},
+        {0xD3515C2831559A83, -954, -268},
+        {0x9D71AC8FADA6C9B5, -927, -260},
+        {0xEA9C227723EE8BCB, -901, -252},
+        {0xAECC49914078536D, -874, -244},
+        {0x823C12795DB6CE57, -847, -236},
+        {0xC21094364DFB5637, -821, -228},
+        {0x9096EA6F3848984F, -794, -220},
+        {0xD77485CB25823AC7, -768, -212},
+        {0xA086CFCD97BF97F4, -741, -204},
+        {0xEF340A98172AACE5, -715, -196},
+        {0xB23867FB2A35B28E, -688, -188},
+        {0x84C8D4DFD2C63F3B, -661, -180},
+        {0xC5DD44271AD3CDBA, -635, -172},
+        {0x936B9FCEBB25C996, -608, -164},
+        {0xDBAC6C247D62A584, -582, -156},
+        {0xA3AB66580D5FDAF6, -555, -148},
+        {0xF3E2F893DEC3F126, -529, -140},
+        {0xB5B5ADA8AAFF80B8, -502, -132},
+        {0x87625F056C7C4A8B, -475, -124},
+        {0xC9BCFF6034C13053, -449, -116},
+        {0x964E858C91BA2655, -422, -108},
+        {0xDFF9772470297EBD, -396, -100},
+        {0xA6DFBD9FB8E5B88F, -369, -92},
+        {0xF8A95FCF88747D94, -343, -84},
+        {0xB94470938FA89BCF, -316, -76},
+        {0x8A08F0F8BF0F156B, -289, -68},
+        {0xCDB02555653131B6, -263, -60},
+        {0x993FE2C6D07B7FAC, -236, -52},
+        {0xE45C10C42A2B3B06, -210, -44},
+        {0xAA242499697392D3, -183, -36},
+        {0xFD87B5F28300CA0E, -157, -28},
+        {0xBCE5086492111AEB, -130, -20},
+        {0x8CBCCC096F5088CC, -103, -12},
+        {0xD1B71758E219652C, -77, -4},
+        {0x9C40000000000000, -50, 4},
+        {0xE8D4A51000000000, -24, 12},
+        {0xAD78EBC5AC620000, 3, 20},
+        {0x813F3978F8940984, 30, 28},
+        {0xC097CE7BC90715B3, 56, 36},
+        {0x8F7E32CE7BEA5C70, 83, 44},
+        {0xD5D238A4ABE98068, 109, 52},
+        {0x9F4F2726179A2245, 136, 60},
+        {0xED63A231D4C4FB27, 162, 68},
+        {0xB0DE65388CC8ADA8, 189, 76},
+        {0x83C7088E1AAB65DB, 216, 84},
+        {0xC45D1DF942711D9A, 242, 92},
+        {0x924D692CA61BE758, 269, 100},
+        {0xDA01EE641A708DEA, 295, 108},
+        {0xA26DA3999AEF774A, 322, 116},
+        {0xF209787BB47D6B85, 348, 124},
+        {0xB454E4A179DD1877, 375, 132},
+        {0x865B86925B9BC5C2, 402, 140},
+        {0xC83553C5C8965D3D, 428, 148},
+        {0x952AB45CFA97A0B3, 455, 156},
+        {0xDE469FBD99A05FE3, 481, 164},
+        {0xA59BC234DB398C25, 508, 172},
+        {0xF6C69A72A3989F5C, 534, 180},
+        {0xB7DCBF5354E9BECE, 561, 188},
+        {0x88FCF317F22241E2, 588, 196},
+        {0xCC20CE9BD35C78A5, 614, 204},
+        {0x98165AF37B2153DF, 641, 212},
+        {0xE2A0B5DC971F303A, 667, 220},
+        {0xA8D9D1535CE3B396, 694, 228},
+        {0xFB9B7CD9A4A7443C, 720, 236},
+        {0xBB764C4CA7A44410, 747, 244},
+        {0x8BAB8EEFB6409C1A, 774, 252},
+        {0xD01FEF10A657842C, 800, 260},
+        {0x9B10A4E5E9913129, 827, 268},
+        {0xE7109BFBA19C0C9D, 853, 276},
+        {0xAC2820D9623BF429, 880, 284},
+        {0x80444B5E7AA7CF85, 907, 292},
+        {0xBF21E44003ACDD2D, 933, 300},
+        {0x8E679C2F5E44FF8F, 960, 308},
+        {0xD433179D9C8CB841, 986, 316},
+        {0x9E19DB92B4E31BA9, 1013, 324},
+        {0xEB96BF6EBADF77D9, 1039, 332},
+        {0xAF87023B9BF0EE6B, 1066, 340},
+    };
+
+    const auto min_decimal_exponent = -300;
+    const auto decimal_step = 8;
+
+    // 78913 / 2^18 approximates log10(2)
+    const auto f = min_scaled_exponent - binary_exponent - 1;
+    const auto k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+    const auto index = (k - min_decimal_exponent + decimal_step - 1) / decimal_step;
+
+    return powers[index];
+}
+
+/// <summary>
+/// Returns the number of decimal digits in n and sets power to 10^(digits - 1).
+/// </summary>
+int largest_power_of_ten(std::uint32_t n, std::uint32_t &power)
+{
+    auto digits = 1;
+    power = 1;
+
+    while (digits < 10 && n / power >= 10)
+    {
+        power *= 10;
+        ++digits;
+    }
+
+    return digits;
+}
+
+/// <summary>
+/// Moves the last digit of buffer towards the scaled value w, which is dist
+/// below the upper boundary, while the digits stay within the boundaries.
+/// </summary>
+void round_digits(char *buffer, int length, std::uint64_t dist, std::uint64_t delta, std::uint64_t rest,
+    std::uint64_t ten_k)
+{
+    while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        --buffer[length - 1];
+        rest += ten_k;
+    }
+}
+
+/// <summary>
+/// Generates the shortest digits of w that lie between the scaled boundaries
+/// minus and plus. The value written is the digits times 10^decimal_exponent.
+/// </summary>
+void generate_digits(char *buffer, int &length, int &decimal_exponent, diy_fp minus, diy_fp w, diy_fp plus)
+{
+    auto delta = subtract(plus, minus).f;
+    auto dist = subtract(plus, w).f;
+
+    const auto one = diy_fp{std::uint64_t(1) << -plus.e, plus.e};
+
+    auto integral = static_cast<std::uint32_t>(plus.f >> -one.e);
+    auto fractional = plus.f & (one.f - 1);
+
+    std::uint32_t power = 0;
+    auto remaining = largest_power_of_ten(integral, power);
+
+    while (remaining > 0)
+    {
+        const auto digit = integral / power;
+        integral %= power;
+        buffer[length++] = static_cast<char>('0' + digit);
+        --remaining;
+
+        const auto rest = (static_cast<std::uint64_t>(integral) << -one.e) + fractional;
+
+        if (rest <= delta)
+        {
+            decimal_exponent += remaining;
+            round_digits(buffer, length, dist, delta, rest, static_cast<std::uint64_t>(power) << -one.e);
+
+            return;
+        }
+
+        power /= 10;
+    }
+
+    auto fractional_digits = 0;
+
+    while (true)
+    {
+        fractional *= 10;
+        buffer[length++] = static_cast<char>('0' + (fractional >> -one.e));
+        fractional &= one.f - 1;
+        ++fractional_digits;
+
+        delta *= 10;
+        dist *= 10;
+
+        if (fractional <= delta)
+        {
+            break;
+        }
+    }
+
+    decimal_exponent -= fractional_digits;
+    round_digits(buffer, length, dist, delta, fractional, one.f);
+}
+
+/// <summary>
+/// Writes the shortest digits of the positive value to buffer with Grisu2.
+/// The number written is the digits times 10^decimal_exponent.
+/// </summary>
+void shortest_digits(double value, char *buffer, int &length, int &decimal_exponent)
+{
+    const auto bounds = compute_boundaries(value);
+    const auto cached = cached_power_for(bounds.plus.e);
+    const auto c = diy_fp{cached.f, cached.e};
+
+    const auto w = multiply(bounds.w, c);
+    const auto w_minus = multiply(bounds.minus, c);
+    const auto w_plus = multiply(bounds.plus, c);
+
+    // shrink the boundaries by one unit to allow for the error in the products
+    const auto minus = diy_fp{w_minus.f + 1, w_minus.e};
+    const auto plus = diy_fp{w_plus.f - 1, w_plus.e};
+
+    length = 0;
+    decimal_exponent = -cached.k;
+    generate_digits(buffer, length, decimal_exponent, minus, w, plus);
+}
+
+std::size_t write_exponent(int exponent, char *buffer)
+{
+    auto position = buffer;
+    *position++ = 'E';
+    *position++ = exponent < 0 ? '-' : '+';
+
+    auto magnitude = exponent < 0 ? -exponent : exponent;
+
+    if (magnitude >= 100)
+    {
+        *position++ = static_cast<char>('0' + magnitude / 100);
+        magnitude %= 100;
+        *position++ = static_cast<char>('0' + magnitude / 10);
+    }
+    else if (magnitude >= 10)
+    {
+        *position++ = static_cast<char>('0' + magnitude / 10);
+    }
+
+    *position++ = static_cast<char>('0' + magnitude % 10);
+
+    return static_cast<std::size_t>(position - buffer);
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+bool parse_number(const char *first, const char *last, long double &value)
+{
+    auto position = first;
+    const auto negative = position != last && *position == '-';
+
+    if (negative || (position != last && *position == '+'))
+    {
+        ++position;
+    }
+
+    std::uint64_t mantissa = 0;
+    auto mantissa_digits = 0;
+    auto exponent = 0;
+    auto has_digits = false;
+    auto too_many_digits = false;
+
+    // leading zeros aren't significant so they don't count towards the digits
+    // that fit in the mantissa
+    auto append_digit = [&](char digit) {
+        has_digits = true;
+
+        if (mantissa == 0 && digit == '0')
+        {
+            return;
+        }
+
+        if (mantissa_digits == max_mantissa_digits)
+        {
+            too_many_digits = true;
+            return;
+        }
+
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(digit - '0');
+        ++mantissa_digits;
+    };
+
+    while (position != last && is_digit(*position))
+    {
+        append_digit(*position++);
+    }
+
+    if (position != last && *position == '.')
+    {
+        ++position;
+
+        while (position != last && is_digit(*position))
+        {
+            append_digit(*position++);
+            --exponent;
+        }
+    }
+
+    if (!has_digits)
+    {
+        return false;
+    }
+
+    if (position != last && (*position == 'e' || *position == 'E'))
+    {
+        ++position;
+        const auto negative_exponent = position != last && *position == '-';
+
+        if (negative_exponent || (position != last && *position == '+'))
+        {
+            ++position;
+        }
+
+        if (position == last)
+        {
+            return false;
+        }
+
+        auto written_exponent = 0;
+
+        while (position != last && is_digit(*position))
+        {
+            // anything this large is out of range anyway and is left to the slow path
+            if (written_exponent < 100000)
+            {
+                written_exponent = written_exponent * 10 + (*position - '0');
+            }
+
+            ++position;
+        }
+
+        exponent += negative_exponent ? -written_exponent : written_exponent;
+    }
+
+    if (position != last)
+    {
+        return false;
+    }
+
+    if (mantissa == 0 && !too_many_digits)
+    {
+        value = negative ? -0.0L : 0.0L;
+        return true;
+    }
+
+    // a single multiplication or division of two exactly represented values
+    // is correctly rounded, so this gives the same result as strtold
+    if (too_many_digits || !exact_mantissa(mantissa) || exponent < -max_exact_power()
+        || exponent > max_exact_power())
+    {
+        return parse_number_slow(first, last, value);
+    }
+
+    auto result = static_cast<long double>(mantissa);
+    result = exponent < 0 ? result / power_of_ten(-exponent) : result * power_of_ten(exponent);
+    value = negative ? -result : result;
+
+    return true;
+}
+
+std::size_t write_shortest_number(double value, char *buffer)
+{
+    auto position = buffer;
+
+    if (std::signbit(value))
+    {
+        *position++ = '-';
+        value = -value;
+    }
+
+    if (value == 0)
+    {
+        *position++ = '0';
+        return static_cast<std::size_t>(position - buffer);
+    }
+
+    // the digits are generated first and then laid out in buffer around the decimal point
+    char digits[20];
+    auto length = 0;
+    auto decimal_exponent = 0;
+    shortest_digits(value, digits, length, decimal_exponent);
+
+    // the position of the decimal point relative to the first digit
+    const auto point = length + decimal_exponent;
+
+    if (point > 16 || point < -4)
+    {
+        *position++ = digits[0];
+
+        if (length > 1)
+        {
+            *position++ = '.';
+            std::memcpy(position, digits + 1, static_cast<std::size_t>(length - 1));
+            position += length - 1;
+        }
+
+        position += write_exponent(point - 1, position);
+    }
+    else if (point >= length)
+    {
+        std::memcpy(position, digits, static_cast<std::size_t>(length));
+        position += length;
+        std::memset(position, '0', static_cast<std::size_t>(point - length));
+        position += point - length;
+    }
+    else if (point > 0)
+    {
+        std::memcpy(position, digits, static_cast<std::size_t>(point));
+        position += point;
+        *position++ = '.';
+        std::memcpy(position, digits + point, static_cast<std::size_t>(length - point));
+        position += length - point;
+    }
+    else
+    {
+        *position++ = '0';
+        *position++ = '.';
+        std::memset(position, '0', static_cast<std::size_t>(-point));
+        position += -point;
+        std::memcpy(position, digits, static_cast<std::size_t>(length));
+        position += length;
+    }
+
+    return static_cast<std::size_t>(position - buffer);
+}
+
+} // namespace detail
+} // namespace xlnt
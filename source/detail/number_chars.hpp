@@ -0,0 +1,57 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Parses the decimal number in [first, last), such as "42", "-0.5" or "1.5E-3",
+/// into value. Like std::from_chars, this doesn't consult a locale and the whole
+/// range must be a number. The result is the nearest long double to the text.
+/// Returns false and leaves value unchanged if the range isn't a number.
+/// </summary>
+bool parse_number(const char *first, const char *last, long double &value);
+
+/// <summary>
+/// The size of a buffer that is large enough for any number written by
+/// write_shortest_number.
+/// </summary>
+const std::size_t max_number_chars = 32;
+
+/// <summary>
+/// Writes the shortest decimal text that parses back to exactly value, such as
+/// "0.1" rather than "0.10000000000000001", to buffer and returns the number
+/// of characters written. No terminating null is written and no locale is
+/// consulted. Magnitudes from 1E-5 up to but excluding 1E+16 are written in
+/// positional notation and others in scientific notation like "1.5E-7".
+/// value must be finite.
+/// </summary>
+std::size_t write_shortest_number(double value, char *buffer);
+
+} // namespace detail
+} // namespace xlnt
@@ -23,6 +23,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <utility>
 
 #include <detail/default_case.hpp>
 #include <detail/number_format/number_formatter.hpp>
@@ -78,6 +82,90 @@ void unhandled_case(bool error)
     }
 }
 
+void append_unsigned(std::string &result, unsigned long long value)
+{
+    char digits[20];
+    auto end = digits + sizeof(digits);
+    auto begin = end;
+
+    do
+    {
+        *--begin = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    result.append(begin, end);
+}
+
+void append_integer(std::string &result, long long value)
+{
+    if (value < 0)
+    {
+        result.push_back('-');
+        append_unsigned(result, 0ULL - static_cast<unsigned long long>(value));
+    }
+    else
+    {
+        append_unsigned(result, static_cast<unsigned long long>(value));
+    }
+}
+
+/// <summary>
+/// Appends number with six decimal places exactly as std::to_string would
+/// without allocating. Numbers whose seventh decimal place is too close to a
+/// rounding boundary to round reliably in floating point, as well as very large
+/// or non-finite numbers, are formatted by snprintf instead.
+/// </summary>
+void append_fixed(std::string &result, long double number)
+{
+    static const auto max_scaled = std::ldexp(1.0L, std::numeric_limits<long double>::digits - 12);
+
+    const auto scaled = std::fabs(number * 1000000.L);
+
+    if (scaled < max_scaled)
+    {
+        const auto whole = std::floor(scaled);
+        const auto remainder = scaled - whole;
+
+        if (std::fabs(remainder - 0.5L) > 0.001L)
+        {
+            auto units = static_cast<unsigned long long>(whole) + (remainder > 0.5L ? 1 : 0);
+
+            if (std::signbit(number))
+            {
+                result.push_back('-');
+            }
+
+            append_unsigned(result, units / 1000000);
+            result.push_back('.');
+
+            char fraction[6];
+            units %= 1000000;
+
+            for (auto i = 5; i >= 0; --i)
+            {
+                fraction[i] = static_cast<char>('0' + units % 10);
+                units /= 10;
+            }
+
+            result.append(fraction, sizeof(fraction));
+            return;
+        }
+    }
+
+    char buffer[64];
+    const auto length = std::snprintf(buffer, sizeof(buffer), "%Lf", number);
+
+    if (length > 0 && static_cast<std::size_t>(length) < sizeof(buffer))
+    {
+        result.append(buffer, static_cast<std::size_t>(length));
+    }
+    else
+    {
+        result.append(std::to_string(number));
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -1068,38 +1156,87 @@ std::pair<format_locale, std::string> number_format_parser::locale_from_string(c
     throw std::runtime_error("unknown country code: " + country_code_string);
 }
 
+std::shared_ptr<const std::vector<format_code>> compiled_number_format(const std::string &format_string)
+{
+    // Workbooks rarely use more than a few dozen formats, so this is only a
+    // guard against unbounded growth. Discarding the cache doesn't invalidate
+    // formats that are still held by callers.
+    static const std::size_t max_cached_formats = 4096;
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const std::vector<format_code>>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto match = cache.find(format_string);
+
+        if (match != cache.end())
+        {
+            return match->second;
+        }
+    }
+
+    // parse outside of the lock so that other threads aren't blocked and
+    // invalid formats, which throw, aren't cached
+    number_format_parser parser(format_string);
+    parser.parse();
+    auto compiled = std::make_shared<const std::vector<format_code>>(parser.result());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (cache.size() >= max_cached_formats)
+    {
+        cache.clear();
+    }
+
+    return cache.emplace(format_string, compiled).first->second;
+}
+
 number_formatter::number_formatter(const std::string &format_string, xlnt::calendar calendar)
-    : parser_(format_string), calendar_(calendar)
+    : number_formatter(compiled_number_format(format_string), calendar)
+{
+}
+
+number_formatter::number_formatter(std::shared_ptr<const std::vector<format_code>> format, xlnt::calendar calendar)
+    : compiled_(std::move(format)), format_(*compiled_), calendar_(calendar)
 {
-    parser_.parse();
-    format_ = parser_.result();
 }
 
 std::string number_formatter::format_number(long double number)
+{
+    std::string result;
+    format_number(number, result);
+
+    return result;
+}
+
+void number_formatter::format_number(long double number, std::string &result)
 {
     if (format_[0].has_condition)
     {
         if (format_[0].condition.satisfied_by(number))
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
 
         if (format_.size() == 1)
         {
-            return std::string(11, '#');
+            result.append(11, '#');
+            return;
         }
 
         if (!format_[1].has_condition || format_[1].condition.satisfied_by(number))
         {
-            return format_number(format_[1], number);
+            return format_number(format_[1], number, result);
         }
 
         if (format_.size() == 2)
         {
-            return std::string(11, '#');
+            result.append(11, '#');
+            return;
         }
 
-        return format_number(format_[2], number);
+        return format_number(format_[2], number, result);
     }
 
     // no conditions, format based on sign:
@@ -1107,18 +1244,18 @@ std::string number_formatter::format_number(long double number)
     // 1 section, use for all
     if (format_.size() == 1)
     {
-        return format_number(format_[0], number);
+        return format_number(format_[0], number, result);
     }
     // 2 sections, first for positive and zero, second for negative
     else if (format_.size() == 2)
     {
         if (number >= 0)
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
         else
         {
-            return format_number(format_[1], std::fabs(number));
+            return format_number(format_[1], std::fabs(number), result);
         }
     }
     // 3+ sections, first for positive, second for negative, third for zero
@@ -1126,54 +1263,66 @@ std::string number_formatter::format_number(long double number)
     {
         if (number > 0)
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
         else if (number < 0)
         {
-            return format_number(format_[1], std::fabs(number));
+            return format_number(format_[1], std::fabs(number), result);
         }
         else
         {
-            return format_number(format_[2], number);
+            return format_number(format_[2], number, result);
         }
     }
 }
 
 std::string number_formatter::format_text(const std::string &text)
+{
+    std::string result;
+    format_text(text, result);
+
+    return result;
+}
+
+void number_formatter::format_text(const std::string &text, std::string &result)
 {
     if (format_.size() < 4)
     {
-        format_code temp;
-        template_part temp_part;
-        temp_part.type = template_part::template_type::general;
-        temp_part.placeholders.type = format_placeholders::placeholders_type::general;
-        temp.parts.push_back(temp_part);
-        return format_text(temp, text);
+        static const format_code *general = []() {
+            auto code = new format_code();
+            template_part part;
+            part.type = template_part::template_type::general;
+            part.placeholders.type = format_placeholders::placeholders_type::general;
+            code->parts.push_back(part);
+            return code;
+        }();
+
+        return format_text(*general, text, result);
     }
 
-    return format_text(format_[3], text);
+    return format_text(format_[3], text, result);
 }
 
-std::string number_formatter::fill_placeholders(const format_placeholders &p, long double number)
+void number_formatter::fill_placeholders(const format_placeholders &p, long double number, std::string &result)
 {
-    std::string result;
+    const auto start = result.size();
 
     if (p.type == format_placeholders::placeholders_type::general
         || p.type == format_placeholders::placeholders_type::text)
     {
-        result = std::to_string(number);
+        append_fixed(result, number);
 
-        while (result.back() == '0')
+        while (result.size() > start && result.back() == '0')
         {
             result.pop_back();
         }
 
-        if (result.back() == '.')
+        if (result.size() > start && result.back() == '.')
         {
             result.pop_back();
         }
 
-        return result;
+        return;
     }
 
     if (p.percentage)
@@ -1186,40 +1335,42 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, lo
         number /= std::pow(1000.L, p.thousands_scale);
     }
 
-    auto integer_part = static_cast<int>(number);
+    auto integer_part = static_cast<long long>(number);
 
     if (p.type == format_placeholders::placeholders_type::integer_only
         || p.type == format_placeholders::placeholders_type::integer_part
         || p.type == format_placeholders::placeholders_type::fraction_integer)
     {
-        result = std::to_string(integer_part);
+        append_integer(result, integer_part);
 
-        while (result.size() < p.num_zeros)
-        {
-            result = "0" + result;
-        }
+        const auto digits = result.size() - start;
+        const auto zeros = p.num_zeros > digits ? p.num_zeros - digits : 0;
+        const auto padded = digits + zeros;
+        const auto spaces = p.num_zeros + p.num_spaces > padded ? p.num_zeros + p.num_spaces - padded : 0;
 
-        while (result.size() < p.num_zeros + p.num_spaces)
-        {
-            result = " " + result;
-        }
+        result.insert(start, zeros, '0');
+        result.insert(start, spaces, ' ');
 
         if (p.use_comma_separator)
         {
-            std::vector<char> digits(result.rbegin(), result.rend());
-            std::string temp;
+            // spread the digits out from the right to make room for a comma
+            // between each group of three
+            const auto length = result.size() - start;
+            const auto commas = (length - 1) / 3;
+            result.resize(result.size() + commas);
 
-            for (std::size_t i = 0; i < digits.size(); i++)
-            {
-                temp.push_back(digits[i]);
+            auto source = start + length;
+            auto destination = result.size();
 
-                if (i % 3 == 2)
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                if (i > 0 && i % 3 == 0)
                 {
-                    temp.push_back(',');
+                    result[--destination] = ',';
                 }
-            }
 
-            result = std::string(temp.rbegin(), temp.rend());
+                result[--destination] = result[--source];
+            }
         }
 
         if (p.percentage && p.type == format_placeholders::placeholders_type::integer_only)
@@ -1230,23 +1381,33 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, lo
     else if (p.type == format_placeholders::placeholders_type::fractional_part)
     {
         auto fractional_part = number - integer_part;
-        result = std::fabs(fractional_part) < std::numeric_limits<long double>::min()
-            ? std::string(".")
-            : std::to_string(fractional_part).substr(1);
 
-        while (result.back() == '0' || result.size() > (p.num_zeros + p.num_optionals + p.num_spaces + 1))
+        if (std::fabs(fractional_part) < std::numeric_limits<long double>::min())
+        {
+            result.push_back('.');
+        }
+        else
+        {
+            // drop the leading zero
+            append_fixed(result, fractional_part);
+            result.erase(start, 1);
+        }
+
+        const auto width = p.num_zeros + p.num_optionals + p.num_spaces + 1;
+
+        while (result.size() > start && (result.back() == '0' || result.size() - start > width))
         {
             result.pop_back();
         }
 
-        while (result.size() < p.num_zeros + 1)
+        if (result.size() - start < p.num_zeros + 1)
         {
-            result.push_back('0');
+            result.append(p.num_zeros + 1 - (result.size() - start), '0');
         }
 
-        while (result.size() < p.num_zeros + p.num_optionals + p.num_spaces + 1)
+        if (result.size() - start < width)
         {
-            result.push_back(' ');
+            result.append(width - (result.size() - start), ' ');
         }
 
         if (p.percentage)
@@ -1254,8 +1415,6 @@ std::string number_formatter::fill_placeholders(const format_placeholders &p, lo
             result.push_back('%');
         }
     }
-
-    return result;
 }
 
 std::string number_formatter::fill_scientific_placeholders(const format_placeholders &integer_part,
@@ -1350,7 +1509,7 @@ std::string number_formatter::fill_fraction_placeholders(const format_placeholde
     return std::to_string(numerator_rounded) + "/" + std::to_string(best_denominator);
 }
 
-std::string number_formatter::format_number(const format_code &format, long double number)
+void number_formatter::format_number(const format_code &format, long double number, std::string &result)
 {
     static const std::vector<std::string> *month_names = new std::vector<std::string>{"January", "February", "March",
         "April", "May", "June", "July", "August", "September", "October", "November", "December"};
@@ -1358,16 +1517,17 @@ std::string number_formatter::format_number(const format_code &format, long doub
     static const std::vector<std::string> *day_names =
         new std::vector<std::string>{"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 
-    std::string result;
+    const auto start = result.size();
 
     if (number < 0)
     {
-        result.push_back('-');
-
         if (format.is_datetime)
         {
-            return std::string(11, '#');
+            result.append(11, '#');
+            return;
         }
+
+        result.push_back('-');
     }
 
     number = std::fabs(number);
@@ -1398,7 +1558,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
     bool improper_fraction = true;
     std::size_t fill_index = 0;
     bool fill = false;
-    std::string fill_character;
+    const std::string *fill_character = nullptr;
 
     for (std::size_t i = 0; i < format.parts.size(); ++i)
     {
@@ -1422,7 +1582,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
             {
                 fill = true;
                 fill_index = result.size();
-                fill_character = part.string;
+                fill_character = &part.string;
                 break;
             }
 
@@ -1436,7 +1596,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     auto denominator = static_cast<int>(std::pow(10.0, digits));
                     auto fractional_seconds = dt.microsecond / 1.0E6L * denominator;
                     fractional_seconds = std::round(fractional_seconds) / denominator;
-                    result.append(fill_placeholders(part.placeholders, fractional_seconds));
+                    fill_placeholders(part.placeholders, fractional_seconds, result);
                     break;
                 }
 
@@ -1469,7 +1629,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
                 }
                 else
                 {
-                    result.append(fill_placeholders(part.placeholders, number));
+                    fill_placeholders(part.placeholders, number, result);
                 }
 
                 break;
@@ -1477,7 +1637,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
 
         case template_part::template_type::day_number:
             {
-                result.append(std::to_string(dt.day));
+                append_integer(result, dt.day);
                 break;
             }
 
@@ -1488,13 +1648,13 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.day));
+                append_integer(result, dt.day);
                 break;
             }
 
         case template_part::template_type::month_abbreviation:
             {
-                result.append(month_names->at(static_cast<std::size_t>(dt.month) - 1).substr(0, 3));
+                result.append(month_names->at(static_cast<std::size_t>(dt.month) - 1), 0, 3);
                 break;
             }
 
@@ -1506,7 +1666,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
 
         case template_part::template_type::month_number:
             {
-                result.append(std::to_string(dt.month));
+                append_integer(result, dt.month);
                 break;
             }
 
@@ -1517,7 +1677,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.month));
+                append_integer(result, dt.month);
                 break;
             }
 
@@ -1528,19 +1688,19 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.year % 1000));
+                append_integer(result, dt.year % 1000);
                 break;
             }
 
         case template_part::template_type::year_long:
             {
-                result.append(std::to_string(dt.year));
+                append_integer(result, dt.year);
                 break;
             }
 
         case template_part::template_type::hour:
             {
-                result.append(std::to_string(hour));
+                append_integer(result, static_cast<long long>(hour));
                 break;
             }
 
@@ -1551,13 +1711,13 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(hour));
+                append_integer(result, static_cast<long long>(hour));
                 break;
             }
 
         case template_part::template_type::minute:
             {
-                result.append(std::to_string(dt.minute));
+                append_integer(result, dt.minute);
                 break;
             }
 
@@ -1568,19 +1728,19 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.minute));
+                append_integer(result, dt.minute);
                 break;
             }
 
         case template_part::template_type::second:
             {
-                result.append(std::to_string(dt.second + (dt.microsecond > 500000 ? 1 : 0)));
+                append_integer(result, dt.second + (dt.microsecond > 500000 ? 1 : 0));
                 break;
             }
 
         case template_part::template_type::second_fractional:
             {
-                result.append(std::to_string(dt.second));
+                append_integer(result, dt.second);
                 break;
             }
 
@@ -1591,7 +1751,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.second + (dt.microsecond > 500000 ? 1 : 0)));
+                append_integer(result, dt.second + (dt.microsecond > 500000 ? 1 : 0));
                 break;
             }
 
@@ -1602,7 +1762,7 @@ std::string number_formatter::format_number(const format_code &format, long doub
                     result.push_back('0');
                 }
 
-                result.append(std::to_string(dt.second));
+                append_integer(result, dt.second);
                 break;
             }
 
@@ -1636,33 +1796,33 @@ std::string number_formatter::format_number(const format_code &format, long doub
 
         case template_part::template_type::elapsed_hours:
             {
-                result.append(std::to_string(24 * static_cast<int>(number) + dt.hour));
+                append_integer(result, 24 * static_cast<int>(number) + dt.hour);
                 break;
             }
 
         case template_part::template_type::elapsed_minutes:
             {
-                result.append(std::to_string(24 * 60 * static_cast<int>(number)
-                    + (60 * dt.hour) + dt.minute));
+                append_integer(result, 24 * 60 * static_cast<int>(number)
+                    + (60 * dt.hour) + dt.minute);
                 break;
             }
 
         case template_part::template_type::elapsed_seconds:
             {
-                result.append(std::to_string(24 * 60 * 60 * static_cast<int>(number)
-                    + (60 * 60 * dt.hour) + (60 * dt.minute) + dt.second));
+                append_integer(result, 24 * 60 * 60 * static_cast<int>(number)
+                    + (60 * 60 * dt.hour) + (60 * dt.minute) + dt.second);
                 break;
             }
 
         case template_part::template_type::month_letter:
             {
-                result.append(month_names->at(static_cast<std::size_t>(dt.month) - 1).substr(0, 1));
+                result.push_back(month_names->at(static_cast<std::size_t>(dt.month) - 1).front());
                 break;
             }
 
         case template_part::template_type::day_abbreviation:
             {
-                result.append(day_names->at(static_cast<std::size_t>(dt.weekday()) - 1).substr(0, 3));
+                result.append(day_names->at(static_cast<std::size_t>(dt.weekday()) - 1), 0, 3);
                 break;
             }
 
@@ -1676,22 +1836,17 @@ std::string number_formatter::format_number(const format_code &format, long doub
 
     const std::size_t width = 11;
 
-    if (fill && result.size() < width)
+    if (fill && result.size() - start < width)
     {
-        auto remaining = width - result.size();
+        auto remaining = width - (result.size() - start);
 
-        std::string fill_string(remaining, fill_character.front());
         // TODO: A UTF-8 character could be multiple bytes
-
-        result = result.substr(0, fill_index) + fill_string + result.substr(fill_index);
+        result.insert(fill_index, remaining, fill_character->front());
     }
-
-    return result;
 }
 
-std::string number_formatter::format_text(const format_code &format, const std::string &text)
+void number_formatter::format_text(const format_code &format, const std::string &text, std::string &result)
 {
-    std::string result;
     bool any_text_part = false;
 
     for (const auto &part : format.parts)
@@ -1712,12 +1867,11 @@ std::string number_formatter::format_text(const format_code &format, const std::
         }
     }
 
+    // nothing has been appended if there weren't any text parts
     if (!format.parts.empty() && !any_text_part)
     {
-        return text;
+        result.append(text);
     }
-
-    return result;
 }
 
 } // namespace detail
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -348,25 +349,44 @@ private:
     std::vector<format_code> codes_;
 };
 
+/// <summary>
+/// Returns the parsed sections of format_string. Each distinct format string is
+/// only parsed once and the result is shared by every caller, so repeatedly
+/// formatting cells with the same number format doesn't reparse it. This is
+/// safe to call from multiple threads.
+/// </summary>
+std::shared_ptr<const std::vector<format_code>> compiled_number_format(const std::string &format_string);
+
 class XLNT_API number_formatter
 {
 public:
     number_formatter(const std::string &format_string, xlnt::calendar calendar);
+    number_formatter(std::shared_ptr<const std::vector<format_code>> format, xlnt::calendar calendar);
     std::string format_number(long double number);
     std::string format_text(const std::string &text);
 
+    /// <summary>
+    /// Appends number formatted by this format to result.
+    /// </summary>
+    void format_number(long double number, std::string &result);
+
+    /// <summary>
+    /// Appends text formatted by this format to result.
+    /// </summary>
+    void format_text(const std::string &text, std::string &result);
+
 private:
-    std::string fill_placeholders(const format_placeholders &p, long double number);
+    void fill_placeholders(const format_placeholders &p, long double number, std::string &result);
     std::string fill_fraction_placeholders(const format_placeholders &numerator,
         const format_placeholders &denominator, long double number, bool improper);
     std::string fill_scientific_placeholders(const format_placeholders &integer_part,
         const format_placeholders &fractional_part, const format_placeholders &exponent_part,
         long double number);
-    std::string format_number(const format_code &format, long double number);
-    std::string format_text(const format_code &format, const std::string &text);
+    void format_number(const format_code &format, long double number, std::string &result);
+    void format_text(const format_code &format, const std::string &text, std::string &result);
 
-    number_format_parser parser_;
-    std::vector<format_code> format_;
+    std::shared_ptr<const std::vector<format_code>> compiled_;
+    const std::vector<format_code> &format_;
     xlnt::calendar calendar_;
 };
 
@@ -0,0 +1,108 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Returns the 1-based position of character in the alphabet if it is an ASCII
+/// letter of either case, otherwise 0. Unlike std::isalpha and std::toupper,
+/// this doesn't consult a locale.
+/// </summary>
+inline column_t::index_t column_letter_value(char character)
+{
+    const auto offset = static_cast<unsigned int>(static_cast<unsigned char>(character | 0x20)) - 'a';
+    return offset < 26 ? static_cast<column_t::index_t>(offset + 1) : 0;
+}
+
+static_assert(sizeof(column_t::index_t) <= 4, "column letters are assumed to fit in max_column_letters");
+
+/// <summary>
+/// The most letters write_column_letters writes. Any 32-bit column index fits
+/// since 26^7 is greater than 2^32, although columns past ZZZ aren't valid in a file.
+/// </summary>
+const std::size_t max_column_letters = 7;
+
+/// <summary>
+/// The most characters a cell reference can take: two dollar signs, the column
+/// letters and the ten digits of a 32-bit row number.
+/// </summary>
+const std::size_t max_reference_chars = 2 + max_column_letters + 10;
+
+/// <summary>
+/// Writes the letters of the column with the given 1-based index, such as "AB"
+/// for 28, to buffer and returns the number of characters written, at most
+/// max_column_letters.
+/// </summary>
+inline std::size_t write_column_letters(column_t::index_t index, char *buffer)
+{
+    char reversed[max_column_letters];
+    std::size_t length = 0;
+
+    while (index > 0)
+    {
+        const auto remainder = (index - 1) % 26;
+        reversed[length++] = static_cast<char>('A' + remainder);
+        index = (index - 1) / 26;
+    }
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        buffer[i] = reversed[length - i - 1];
+    }
+
+    return length;
+}
+
+/// <summary>
+/// Writes the decimal digits of row to buffer and returns the number of characters
+/// written, at most ten.
+/// </summary>
+inline std::size_t write_row_number(row_t row, char *buffer)
+{
+    char reversed[10];
+    std::size_t length = 0;
+
+    do
+    {
+        reversed[length++] = static_cast<char>('0' + row % 10);
+        row /= 10;
+    } while (row > 0);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        buffer[i] = reversed[length - i - 1];
+    }
+
+    return length;
+}
+
+} // namespace detail
+} // namespace xlnt
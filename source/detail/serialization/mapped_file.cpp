@@ -0,0 +1,132 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <detail/external/include_windows.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <xlnt/utils/path.hpp>
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _MSC_VER
+mapped_file::mapped_file(const std::string &path)
+{
+    auto file = CreateFileW(xlnt::path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER file_size;
+
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping != nullptr)
+        {
+            auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+            if (view != nullptr)
+            {
+                data_ = static_cast<const std::uint8_t *>(view);
+                size_ = static_cast<std::size_t>(file_size.QuadPart);
+            }
+
+            // the view keeps the mapping alive
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+}
+#else
+mapped_file::mapped_file(const std::string &path)
+{
+    auto file = ::open(path.c_str(), O_RDONLY);
+
+    if (file == -1) return;
+
+    struct stat file_stat;
+
+    if (::fstat(file, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+    {
+        const auto length = static_cast<std::size_t>(file_stat.st_size);
+        auto view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (view != MAP_FAILED)
+        {
+#ifdef POSIX_MADV_WILLNEED
+            // every part is read during a load so start reading the whole file in now
+            ::posix_madvise(view, length, POSIX_MADV_WILLNEED);
+#endif
+            data_ = static_cast<const std::uint8_t *>(view);
+            size_ = length;
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(file);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+#endif
+
+bool mapped_file::is_open() const
+{
+    return data_ != nullptr;
+}
+
+const std::uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,83 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A read-only view of the whole contents of a file mapped into memory.
+/// </summary>
+class XLNT_API mapped_file
+{
+public:
+    /// <summary>
+    /// Maps the file at path. If the file can't be opened or mapped,
+    /// is_open returns false and the caller should read it another way.
+    /// </summary>
+    mapped_file(const std::string &path);
+
+    /// <summary>
+    /// Unmaps the file.
+    /// </summary>
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /// <summary>
+    /// Returns true if the file was mapped successfully.
+    /// </summary>
+    bool is_open() const;
+
+    /// <summary>
+    /// Returns a pointer to the first byte of the file.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the size of the file in bytes.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    /// <summary>
+    /// The start of the mapping or nullptr if the file isn't mapped.
+    /// </summary>
+    const std::uint8_t *data_ = nullptr;
+
+    /// <summary>
+    /// The length of the mapping.
+    /// </summary>
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
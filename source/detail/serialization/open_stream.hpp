@@ -0,0 +1,59 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Opens the file at path for binary reading. On Windows, the path is
+/// converted to a wide string first so that non-ASCII filenames work.
+/// </summary>
+XLNT_API void open_stream(std::ifstream &stream, const std::string &path);
+
+/// <summary>
+/// Opens the file at path for binary writing. On Windows, the path is
+/// converted to a wide string first so that non-ASCII filenames work.
+/// </summary>
+XLNT_API void open_stream(std::ofstream &stream, const std::string &path);
+
+#ifdef _MSC_VER
+/// <summary>
+/// Opens the file at the given wide path for binary reading.
+/// </summary>
+XLNT_API void open_stream(std::ifstream &stream, const std::wstring &path);
+
+/// <summary>
+/// Opens the file at the given wide path for binary writing.
+/// </summary>
+XLNT_API void open_stream(std::ofstream &stream, const std::wstring &path);
+#endif
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,647 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <limits>
+
+#include <detail/serialization/sheet_data_tokenizer.hpp>
+
+namespace {
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_name_end(char c)
+{
+    return is_space(c) || c == '/' || c == '>' || c == '=';
+}
+
+template <std::size_t N>
+bool starts_with(const char *first, const char *last, const char (&literal)[N])
+{
+    return static_cast<std::size_t>(last - first) >= N - 1
+        && std::memcmp(first, literal, N - 1) == 0;
+}
+
+// returns the first occurrence of literal in [first, last) or nullptr
+template <std::size_t N>
+const char *find(const char *first, const char *last, const char (&literal)[N])
+{
+    while (first != last)
+    {
+        first = static_cast<const char *>(std::memchr(first, literal[0], static_cast<std::size_t>(last - first)));
+
+        if (first == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (starts_with(first, last, literal))
+        {
+            return first;
+        }
+
+        ++first;
+    }
+
+    return nullptr;
+}
+
+// skips the attributes and end of a tag whose name ends at first, returning
+// the position after its '>' or nullptr if the tag isn't terminated
+const char *skip_tag(const char *first, const char *last, bool &empty)
+{
+    while (first != last)
+    {
+        if (*first == '"' || *first == '\'')
+        {
+            first = static_cast<const char *>(std::memchr(first + 1, *first, static_cast<std::size_t>(last - first - 1)));
+
+            if (first == nullptr)
+            {
+                return nullptr;
+            }
+        }
+        else if (*first == '>')
+        {
+            empty = false;
+            return first + 1;
+        }
+        else if (*first == '/' && starts_with(first, last, "/>"))
+        {
+            empty = true;
+            return first + 2;
+        }
+
+        ++first;
+    }
+
+    return nullptr;
+}
+
+// skips the comment, CDATA section or processing instruction starting at first,
+// returning first if there isn't one there or nullptr if it isn't terminated
+const char *skip_special(const char *first, const char *last)
+{
+    const char *end = first;
+
+    if (starts_with(first, last, "<!--"))
+    {
+        end = find(first + 4, last, "-->");
+        return end == nullptr ? nullptr : end + 3;
+    }
+    else if (starts_with(first, last, "<![CDATA["))
+    {
+        end = find(first + 9, last, "]]>");
+        return end == nullptr ? nullptr : end + 3;
+    }
+    else if (starts_with(first, last, "<?"))
+    {
+        end = find(first + 2, last, "?>");
+        return end == nullptr ? nullptr : end + 2;
+    }
+
+    return first;
+}
+
+// appends the UTF-8 encoding of code_point to text
+bool append_utf8(std::uint64_t code_point, std::string &text)
+{
+    if (code_point < 0x20)
+    {
+        if (code_point != 0x9 && code_point != 0xA && code_point != 0xD)
+        {
+            return false;
+        }
+
+        text.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x80)
+    {
+        text.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        if ((code_point >= 0xD800 && code_point <= 0xDFFF) || code_point >= 0xFFFE)
+        {
+            return false;
+        }
+
+        text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x110000)
+    {
+        text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// appends the character that the reference between '&' and ';' stands for
+bool append_reference(const char *first, const char *last, std::string &text)
+{
+    using range = xlnt::detail::sheet_data_tokenizer::range;
+    const auto name = range{first, last};
+
+    if (name == "lt")
+    {
+        text.push_back('<');
+    }
+    else if (name == "gt")
+    {
+        text.push_back('>');
+    }
+    else if (name == "amp")
+    {
+        text.push_back('&');
+    }
+    else if (name == "quot")
+    {
+        text.push_back('"');
+    }
+    else if (name == "apos")
+    {
+        text.push_back('\'');
+    }
+    else if (starts_with(first, last, "#x"))
+    {
+        auto code_point = std::uint64_t(0);
+
+        if (last - first < 3 || last - first > 8)
+        {
+            return false;
+        }
+
+        for (auto digit = first + 2; digit != last; ++digit)
+        {
+            const auto c = *digit;
+            auto value = 0;
+
+            if (c >= '0' && c <= '9')
+            {
+                value = c - '0';
+            }
+            else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+            {
+                value = (c | 0x20) - 'a' + 10;
+            }
+            else
+            {
+                return false;
+            }
+
+            code_point = code_point * 16 + static_cast<std::uint64_t>(value);
+        }
+
+        return append_utf8(code_point, text);
+    }
+    else if (starts_with(first, last, "#"))
+    {
+        auto code_point = std::uint64_t(0);
+
+        return last - first <= 8
+            && xlnt::detail::sheet_data_tokenizer::to_unsigned(range{first + 1, last}, code_point)
+            && append_utf8(code_point, text);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+bool find_sheet_data(const char *first, const char *last, sheet_data_bounds &bounds)
+{
+    auto position = first;
+    auto empty = false;
+
+    // skip the XML declaration, comments and processing instructions before the root
+    while (true)
+    {
+        position = static_cast<const char *>(std::memchr(position, '<', static_cast<std::size_t>(last - position)));
+
+        if (position == nullptr)
+        {
+            return false;
+        }
+
+        const auto next = skip_special(position, last);
+
+        if (next == nullptr || starts_with(position, last, "<!"))
+        {
+            // a document type declaration could define entities
+            return false;
+        }
+
+        if (next == position)
+        {
+            break;
+        }
+
+        position = next;
+    }
+
+    position = skip_tag(position + 1, last, empty);
+
+    if (position == nullptr || empty)
+    {
+        return false;
+    }
+
+    // visit the children of the root until sheetData is found
+    auto depth = std::size_t(0);
+
+    while (true)
+    {
+        position = static_cast<const char *>(std::memchr(position, '<', static_cast<std::size_t>(last - position)));
+
+        if (position == nullptr || position + 1 == last)
+        {
+            return false;
+        }
+
+        const auto next = skip_special(position, last);
+
+        if (next == nullptr)
+        {
+            return false;
+        }
+        else if (next != position)
+        {
+            position = next;
+            continue;
+        }
+
+        if (position[1] == '/')
+        {
+            if (depth == 0)
+            {
+                // the end of the root
+                return false;
+            }
+
+            --depth;
+            position = skip_tag(position + 2, last, empty);
+
+            if (position == nullptr)
+            {
+                return false;
+            }
+
+            continue;
+        }
+        else if (position[1] == '!')
+        {
+            return false;
+        }
+
+        auto name_last = position + 1;
+
+        while (name_last != last && !is_name_end(*name_last))
+        {
+            ++name_last;
+        }
+
+        if (depth == 0 && sheet_data_tokenizer::range{position + 1, name_last} == "sheetData")
+        {
+            auto tag_end = name_last;
+
+            while (tag_end != last && is_space(*tag_end))
+            {
+                ++tag_end;
+            }
+
+            bounds.element_first = position;
+
+            if (starts_with(tag_end, last, "/>"))
+            {
+                bounds.content_first = bounds.content_last = bounds.element_last = tag_end + 2;
+                return true;
+            }
+            else if (!starts_with(tag_end, last, ">"))
+            {
+                return false;
+            }
+
+            bounds.content_first = tag_end + 1;
+
+            // no '<' can occur in an attribute value or character data, so this
+            // only finds something else if the rows hold a comment or CDATA section,
+            // which the tokenizer stops at before reaching it
+            bounds.content_last = find(bounds.content_first, last, "</sheetData");
+
+            if (bounds.content_last == nullptr)
+            {
+                return false;
+            }
+
+            auto end_tag_end = bounds.content_last + 11;
+
+            while (end_tag_end != last && is_space(*end_tag_end))
+            {
+                ++end_tag_end;
+            }
+
+            if (!starts_with(end_tag_end, last, ">"))
+            {
+                return false;
+            }
+
+            bounds.element_last = end_tag_end + 1;
+
+            return true;
+        }
+
+        position = skip_tag(name_last, last, empty);
+
+        if (position == nullptr)
+        {
+            return false;
+        }
+
+        if (!empty)
+        {
+            ++depth;
+        }
+    }
+}
+
+sheet_data_tokenizer::sheet_data_tokenizer(const char *first, const char *last)
+    : position_(first),
+      last_(last)
+{
+}
+
+bool sheet_data_tokenizer::at_end()
+{
+    skip_whitespace();
+    return position_ == last_;
+}
+
+bool sheet_data_tokenizer::start_tag(const char *name, std::size_t length)
+{
+    skip_whitespace();
+
+    if (failed_
+        || static_cast<std::size_t>(last_ - position_) < length + 2
+        || position_[0] != '<'
+        || std::memcmp(position_ + 1, name, length) != 0
+        || !is_name_end(position_[length + 1]))
+    {
+        return false;
+    }
+
+    position_ += length + 1;
+
+    return true;
+}
+
+bool sheet_data_tokenizer::attribute(range &name, range &value)
+{
+    skip_whitespace();
+
+    if (position_ == last_)
+    {
+        return fail();
+    }
+    else if (*position_ == '>')
+    {
+        ++position_;
+        empty_element_ = false;
+
+        return false;
+    }
+    else if (*position_ == '/')
+    {
+        if (!starts_with(position_, last_, "/>"))
+        {
+            return fail();
+        }
+
+        position_ += 2;
+        empty_element_ = true;
+
+        return false;
+    }
+
+    name.first = position_;
+
+    while (position_ != last_ && !is_name_end(*position_))
+    {
+        ++position_;
+    }
+
+    name.last = position_;
+    skip_whitespace();
+
+    if (name.first == name.last || position_ == last_ || *position_ != '=')
+    {
+        return fail();
+    }
+
+    ++position_;
+    skip_whitespace();
+
+    if (position_ == last_ || (*position_ != '"' && *position_ != '\''))
+    {
+        return fail();
+    }
+
+    const auto quote = *position_++;
+    const auto close = static_cast<const char *>(std::memchr(position_, quote, static_cast<std::size_t>(last_ - position_)));
+
+    if (close == nullptr)
+    {
+        return fail();
+    }
+
+    value.first = position_;
+    value.last = close;
+    position_ = close + 1;
+
+    // values that an XML parser would change by replacing references or
+    // normalizing whitespace aren't handled
+    for (auto c = value.first; c != value.last; ++c)
+    {
+        if (*c == '&' || *c == '<' || *c == '\t' || *c == '\n' || *c == '\r')
+        {
+            return fail();
+        }
+    }
+
+    return true;
+}
+
+bool sheet_data_tokenizer::empty_element() const
+{
+    return empty_element_;
+}
+
+bool sheet_data_tokenizer::end_tag(const char *name, std::size_t length)
+{
+    skip_whitespace();
+
+    if (failed_
+        || static_cast<std::size_t>(last_ - position_) < length + 3
+        || !starts_with(position_, last_, "</")
+        || std::memcmp(position_ + 2, name, length) != 0)
+    {
+        return false;
+    }
+
+    auto end = position_ + length + 2;
+
+    while (end != last_ && is_space(*end))
+    {
+        ++end;
+    }
+
+    if (end == last_ || *end != '>')
+    {
+        return false;
+    }
+
+    position_ = end + 1;
+
+    return true;
+}
+
+bool sheet_data_tokenizer::text(std::string &text)
+{
+    text.clear();
+
+    const auto end = static_cast<const char *>(std::memchr(position_, '<', static_cast<std::size_t>(last_ - position_)));
+
+    if (end == nullptr)
+    {
+        return fail();
+    }
+
+    const auto size = static_cast<std::size_t>(end - position_);
+
+    if (std::memchr(position_, '&', size) == nullptr && std::memchr(position_, '\r', size) == nullptr)
+    {
+        text.assign(position_, end);
+        position_ = end;
+
+        return true;
+    }
+
+    while (position_ != end)
+    {
+        if (*position_ == '&')
+        {
+            const auto semicolon = static_cast<const char *>(std::memchr(position_, ';', static_cast<std::size_t>(end - position_)));
+
+            if (semicolon == nullptr || !append_reference(position_ + 1, semicolon, text))
+            {
+                return fail();
+            }
+
+            position_ = semicolon + 1;
+        }
+        else if (*position_ == '\r')
+        {
+            // line ends are normalized to a single line feed
+            text.push_back('\n');
+            position_ += starts_with(position_, end, "\r\n") ? 2 : 1;
+        }
+        else
+        {
+            text.push_back(*position_++);
+        }
+    }
+
+    return true;
+}
+
+bool sheet_data_tokenizer::failed() const
+{
+    return failed_;
+}
+
+bool sheet_data_tokenizer::to_unsigned(range value, std::uint64_t &number)
+{
+    if (value.first == value.last)
+    {
+        return false;
+    }
+
+    auto result = std::uint64_t(0);
+    const auto max = std::numeric_limits<std::uint64_t>::max();
+
+    for (auto c = value.first; c != value.last; ++c)
+    {
+        const auto digit = static_cast<unsigned int>(*c - '0');
+
+        if (digit > 9 || result > (max - digit) / 10)
+        {
+            return false;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    number = result;
+
+    return true;
+}
+
+void sheet_data_tokenizer::skip_whitespace()
+{
+    while (position_ != last_ && is_space(*position_))
+    {
+        ++position_;
+    }
+}
+
+bool sheet_data_tokenizer::fail()
+{
+    failed_ = true;
+    return false;
+}
+
+} // namespace detail
+} // namespace xlnt
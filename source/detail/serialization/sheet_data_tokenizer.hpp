@@ -0,0 +1,197 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Where the sheetData element of a worksheet part is within its text.
+/// </summary>
+struct sheet_data_bounds
+{
+    /// <summary>
+    /// The start of the "<sheetData" start tag.
+    /// </summary>
+    const char *element_first = nullptr;
+
+    /// <summary>
+    /// The end of the sheetData end tag, or of the start tag if it is an
+    /// empty element.
+    /// </summary>
+    const char *element_last = nullptr;
+
+    /// <summary>
+    /// The start of the rows, just after the start tag.
+    /// </summary>
+    const char *content_first = nullptr;
+
+    /// <summary>
+    /// The end of the rows, at the start of the end tag.
+    /// </summary>
+    const char *content_last = nullptr;
+};
+
+/// <summary>
+/// Finds the sheetData child of the root element of the worksheet part in [first, last).
+/// Returns false if there isn't one or if the part uses anything that makes it
+/// unsafe to find without a full XML parser, such as a document type declaration,
+/// a namespace prefix or attributes on sheetData.
+/// </summary>
+bool find_sheet_data(const char *first, const char *last, sheet_data_bounds &bounds);
+
+/// <summary>
+/// A pull tokenizer for the markup within a worksheet's sheetData element. It
+/// only understands what SpreadsheetML writers produce there: start and end tags
+/// with quoted attributes, whitespace between elements, character data and the
+/// predefined and numeric character references. The text isn't copied, tags are
+/// found with memchr and names are compared directly with the expected literal.
+/// Anything else, including comments, CDATA sections, processing instructions
+/// and other entity references, makes the tokenizer fail so that the caller can
+/// read the part with a full XML parser instead.
+/// </summary>
+class sheet_data_tokenizer
+{
+public:
+    /// <summary>
+    /// A range of characters within the text being tokenized.
+    /// </summary>
+    struct range
+    {
+        const char *first;
+        const char *last;
+
+        /// <summary>
+        /// Returns true if this range holds exactly the given literal.
+        /// </summary>
+        template <std::size_t N>
+        bool operator==(const char (&literal)[N]) const
+        {
+            return static_cast<std::size_t>(last - first) == N - 1
+                && std::memcmp(first, literal, N - 1) == 0;
+        }
+    };
+
+    /// <summary>
+    /// Constructs a tokenizer for the content of a sheetData element in [first, last).
+    /// </summary>
+    sheet_data_tokenizer(const char *first, const char *last);
+
+    /// <summary>
+    /// Skips whitespace and returns true if the end of the content has been reached.
+    /// </summary>
+    bool at_end();
+
+    /// <summary>
+    /// Skips whitespace and, if a start tag with the given name follows, consumes
+    /// its name and returns true. Its attributes should then be read with attribute.
+    /// </summary>
+    template <std::size_t N>
+    bool start_tag(const char (&name)[N])
+    {
+        return start_tag(name, N - 1);
+    }
+
+    /// <summary>
+    /// Reads the next attribute of the current start tag. Returns false once the
+    /// end of the tag has been consumed, after which empty_element tells whether
+    /// it was an empty-element tag. Check failed after this returns false.
+    /// </summary>
+    bool attribute(range &name, range &value);
+
+    /// <summary>
+    /// Returns true if the last start tag whose attributes were read ended with "/>".
+    /// </summary>
+    bool empty_element() const;
+
+    /// <summary>
+    /// Skips whitespace and, if an end tag with the given name follows, consumes
+    /// it and returns true.
+    /// </summary>
+    template <std::size_t N>
+    bool end_tag(const char (&name)[N])
+    {
+        return end_tag(name, N - 1);
+    }
+
+    /// <summary>
+    /// Reads the character data up to the next tag into text, replacing character
+    /// references and normalizing line ends as an XML parser does. Returns false
+    /// if the data uses an entity reference that isn't predefined.
+    /// </summary>
+    bool text(std::string &text);
+
+    /// <summary>
+    /// Returns true if the text was malformed or used something the tokenizer
+    /// doesn't understand.
+    /// </summary>
+    bool failed() const;
+
+    /// <summary>
+    /// Parses the unsigned decimal number in value. Returns false if it is empty,
+    /// has any other character or doesn't fit.
+    /// </summary>
+    static bool to_unsigned(range value, std::uint64_t &number);
+
+private:
+    bool start_tag(const char *name, std::size_t length);
+
+    bool end_tag(const char *name, std::size_t length);
+
+    void skip_whitespace();
+
+    /// <summary>
+    /// Sets failed and returns false.
+    /// </summary>
+    bool fail();
+
+    /// <summary>
+    /// The next character to be read.
+    /// </summary>
+    const char *position_;
+
+    /// <summary>
+    /// The end of the text.
+    /// </summary>
+    const char *last_;
+
+    /// <summary>
+    /// True if the last start tag ended with "/>".
+    /// </summary>
+    bool empty_element_ = false;
+
+    /// <summary>
+    /// True once something that can't be tokenized has been found.
+    /// </summary>
+    bool failed_ = false;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,204 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <detail/constants.hpp>
+#include <detail/number_chars.hpp>
+#include <detail/reference_chars.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <xlnt/utils/exceptions.hpp>
+
+namespace {
+
+// large enough that a flush writes a sizeable chunk to the compressor
+const std::size_t buffer_capacity = 64 * 1024;
+
+// the longest replacement written by write_text
+const std::size_t max_escape_chars = 5;
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+sheet_data_writer::sheet_data_writer(std::ostream &destination)
+    : destination_(destination),
+      buffer_(buffer_capacity),
+      size_(0)
+{
+}
+
+void sheet_data_writer::write_raw(const char *data, std::size_t size)
+{
+    while (size > 0)
+    {
+        if (size_ == buffer_.size())
+        {
+            flush();
+        }
+
+        const auto count = std::min(size, buffer_.size() - size_);
+        std::memcpy(buffer_.data() + size_, data, count);
+        size_ += count;
+        data += count;
+        size -= count;
+    }
+}
+
+void sheet_data_writer::write_unsigned(std::uint64_t value)
+{
+    char reversed[20];
+    std::size_t length = 0;
+
+    do
+    {
+        reversed[length++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    auto position = reserve(length);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        position[i] = reversed[length - i - 1];
+    }
+
+    size_ += length;
+}
+
+void sheet_data_writer::write_number(long double number)
+{
+    // cell values are doubles in the file format
+    const auto value = static_cast<double>(number);
+
+    if (!std::isfinite(value))
+    {
+        std::ostringstream stream;
+        stream << value;
+        const auto text = stream.str();
+        write_raw(text.data(), text.size());
+
+        return;
+    }
+
+    size_ += write_shortest_number(value, reserve(max_number_chars));
+}
+
+void sheet_data_writer::write_reference(column_t::index_t column, row_t row)
+{
+    // any larger index still fits in max_column_letters
+    if (column < constants::min_column().index)
+    {
+        throw invalid_column_index();
+    }
+
+    auto position = reserve(max_reference_chars);
+    position += write_column_letters(column, position);
+    position += write_row_number(row, position);
+    size_ = static_cast<std::size_t>(position - buffer_.data());
+}
+
+void sheet_data_writer::write_text(const std::string &text)
+{
+    auto first = text.data();
+    const auto last = first + text.size();
+
+    while (first != last)
+    {
+        // copy the longest run that needs no escaping in one go
+        auto run_end = first;
+
+        while (run_end != last)
+        {
+            const auto c = static_cast<unsigned char>(*run_end);
+
+            if (c < 0x20 ? c != '\t' && c != '\n' : c == '<' || c == '>' || c == '&')
+            {
+                break;
+            }
+
+            ++run_end;
+        }
+
+        write_raw(first, static_cast<std::size_t>(run_end - first));
+
+        if (run_end == last)
+        {
+            break;
+        }
+
+        auto position = reserve(max_escape_chars);
+
+        switch (*run_end)
+        {
+        case '<':
+            std::memcpy(position, "&lt;", 4);
+            size_ += 4;
+            break;
+
+        case '>':
+            std::memcpy(position, "&gt;", 4);
+            size_ += 4;
+            break;
+
+        case '&':
+            std::memcpy(position, "&amp;", 5);
+            size_ += 5;
+            break;
+
+        case '\r':
+            std::memcpy(position, "&#xD;", 5);
+            size_ += 5;
+            break;
+
+        default:
+            throw xlnt::exception("character can't be represented in XML");
+        }
+
+        first = run_end + 1;
+    }
+}
+
+void sheet_data_writer::flush()
+{
+    destination_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+    size_ = 0;
+}
+
+char *sheet_data_writer::reserve(std::size_t size)
+{
+    if (buffer_.size() - size_ < size)
+    {
+        flush();
+    }
+
+    return buffer_.data() + size_;
+}
+
+} // namespace detail
+} // namespace xlnt
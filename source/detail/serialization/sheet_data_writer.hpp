@@ -0,0 +1,121 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Writes the markup of a worksheet's sheetData element straight into a buffer
+/// which is flushed to a stream when it fills up. Tags are written as literal
+/// fragments, so unlike xml::serializer there is no namespace lookup, attribute
+/// bookkeeping or per-character escaping. The caller is responsible for writing
+/// well-formed markup and for calling flush before anything else is written
+/// to the stream.
+/// </summary>
+class sheet_data_writer
+{
+public:
+    /// <summary>
+    /// Constructs a writer that flushes to destination.
+    /// </summary>
+    sheet_data_writer(std::ostream &destination);
+
+    /// <summary>
+    /// Writes a literal markup fragment such as "<c r=\"". The fragment is
+    /// written as is.
+    /// </summary>
+    template <std::size_t N>
+    void write_fragment(const char (&fragment)[N])
+    {
+        write_raw(fragment, N - 1);
+    }
+
+    /// <summary>
+    /// Writes size characters starting at data as is.
+    /// </summary>
+    void write_raw(const char *data, std::size_t size);
+
+    /// <summary>
+    /// Writes the decimal digits of value.
+    /// </summary>
+    void write_unsigned(std::uint64_t value);
+
+    /// <summary>
+    /// Writes value as the shortest text that reads back as the same double.
+    /// </summary>
+    void write_number(long double value);
+
+    /// <summary>
+    /// Writes a reference like "B7" to the cell in the given column and row.
+    /// </summary>
+    void write_reference(column_t::index_t column, row_t row);
+
+    /// <summary>
+    /// Writes text as element content, escaping the characters that xml::serializer
+    /// escapes there. Text without any such characters is copied as is. Throws
+    /// xlnt::exception if text contains a control character that can't be
+    /// represented in XML.
+    /// </summary>
+    void write_text(const std::string &text);
+
+    /// <summary>
+    /// Writes everything buffered so far to the stream.
+    /// </summary>
+    void flush();
+
+private:
+    /// <summary>
+    /// Makes room for at least size more characters and returns where they
+    /// should be written. size must not exceed the capacity of the buffer.
+    /// </summary>
+    char *reserve(std::size_t size);
+
+    /// <summary>
+    /// The stream that the buffer is flushed to.
+    /// </summary>
+    std::ostream &destination_;
+
+    /// <summary>
+    /// The buffer holding markup that hasn't been flushed yet.
+    /// </summary>
+    std::vector<char> buffer_;
+
+    /// <summary>
+    /// The number of characters in buffer_ that are in use.
+    /// </summary>
+    std::size_t size_;
+};
+
+} // namespace detail
+} // namespace xlnt
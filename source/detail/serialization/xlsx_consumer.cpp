@@ -21,13 +21,21 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <exception>
+#include <limits>
 #include <numeric> // for std::accumulate
+#include <thread>
 
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
 #include <detail/implementations/workbook_impl.hpp>
+#include <detail/number_chars.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/sheet_data_tokenizer.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -35,6 +43,7 @@
 #include <xlnt/cell/comment.hpp>
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/streamed_row.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 
@@ -62,6 +71,103 @@ xml::qname qn(const std::string &namespace_, const std::string &name)
     return xml::qname(xlnt::constants::ns(namespace_), name);
 }
 
+/// <summary>
+/// SpreadsheetML elements which occur once per row, cell or shared string.
+/// They are matched by id against names constructed once rather than against
+/// a new xml::qname for every element read.
+/// </summary>
+enum class sml_element
+{
+    c,
+    f,
+    is,
+    r,
+    row,
+    sheet_data,
+    si,
+    sst,
+    t,
+    v,
+    other
+};
+
+/// <summary>
+/// Returns the interned qualified name of element, which mustn't be sml_element::other.
+/// </summary>
+const xml::qname &qn(sml_element element)
+{
+    static const std::array<xml::qname, 10> names = {{
+        qn("spreadsheetml", "c"),
+        qn("spreadsheetml", "f"),
+        qn("spreadsheetml", "is"),
+        qn("spreadsheetml", "r"),
+        qn("spreadsheetml", "row"),
+        qn("spreadsheetml", "sheetData"),
+        qn("spreadsheetml", "si"),
+        qn("spreadsheetml", "sst"),
+        qn("spreadsheetml", "t"),
+        qn("spreadsheetml", "v"),
+    }};
+
+    return names[static_cast<std::size_t>(element)];
+}
+
+/// <summary>
+/// Returns the id of the element with the given name or sml_element::other if
+/// it isn't one of the interned elements. The length and first character of
+/// the local name select the only possible candidate, which is then compared
+/// in full.
+/// </summary>
+sml_element sml_id(const xml::qname &name)
+{
+    const auto &local = name.name();
+    auto candidate = sml_element::other;
+
+    switch (local.size())
+    {
+    case 1:
+        switch (local[0])
+        {
+        case 'c':
+            candidate = sml_element::c;
+            break;
+        case 'f':
+            candidate = sml_element::f;
+            break;
+        case 'r':
+            candidate = sml_element::r;
+            break;
+        case 't':
+            candidate = sml_element::t;
+            break;
+        case 'v':
+            candidate = sml_element::v;
+            break;
+        }
+        break;
+    case 2:
+        candidate = local[0] == 'i' ? sml_element::is : sml_element::si;
+        break;
+    case 3:
+        candidate = local[0] == 'r' ? sml_element::row : sml_element::sst;
+        break;
+    case 9:
+        candidate = sml_element::sheet_data;
+        break;
+    }
+
+    return candidate != sml_element::other && qn(candidate) == name ? candidate : sml_element::other;
+}
+
+/// <summary>
+/// Returns the interned name of the xml:space attribute, which is checked on every element.
+/// </summary>
+const xml::qname &xml_space()
+{
+    static const xml::qname name = qn("xml", "space");
+    return name;
+}
+
 #ifndef NDEBUG
 #define THROW_ON_INVALID_XML
 #endif
@@ -72,6 +178,34 @@ xml::qname qn(const std::string &namespace_, const std::string &name)
 #define unexpected_element(element) skip_remaining_content(element);
 #endif
 
+// reads everything remaining in buffer
+std::string read_all(std::streambuf &buffer)
+{
+    auto text = std::string(64 * 1024, '\0');
+    auto size = std::size_t(0);
+
+    while (true)
+    {
+        if (size == text.size())
+        {
+            text.resize(text.size() * 2);
+        }
+
+        const auto count = buffer.sgetn(&text[size], static_cast<std::streamsize>(text.size() - size));
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        size += static_cast<std::size_t>(count);
+    }
+
+    text.resize(size);
+
+    return text;
+}
+
 /// <summary>
 /// Returns true if bool_string represents a true xsd:boolean.
 /// </summary>
@@ -95,6 +229,27 @@ bool is_true(const std::string &bool_string)
 #endif
 }
 
+/// <summary>
+/// Parses the number in [first, last) as parse_number does after skipping the
+/// XML whitespace around it, which xsd:double and xsd:unsignedInt allow.
+/// </summary>
+bool parse_xml_number(const char *first, const char *last, long double &value)
+{
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+
+    while (first != last && is_space(*first))
+    {
+        ++first;
+    }
+
+    while (last != first && is_space(*(last - 1)))
+    {
+        --last;
+    }
+
+    return xlnt::detail::parse_number(first, last, value);
+}
+
 /// <summary>
 /// Helper template function that returns true if element is in container.
 /// </summary>
@@ -127,7 +282,7 @@ namespace xlnt {
 namespace detail {
 
 xlsx_consumer::xlsx_consumer(workbook &target)
-    : target_(target),
+    : target_(&target),
       parser_(nullptr)
 {
 }
@@ -138,6 +293,331 @@ void xlsx_consumer::read(std::istream &source)
     populate_workbook();
 }
 
+xlsx_consumer::~xlsx_consumer()
+{
+}
+
+void xlsx_consumer::read(std::istream &source, const load_options &options)
+{
+    options_ = options;
+
+    if (options.lazy_worksheets)
+    {
+        // the stream may be gone by the time a deferred worksheet is read
+        source_data_ = read_all(*source.rdbuf());
+        archive_.reset(new izstream(reinterpret_cast<const std::uint8_t *>(source_data_.data()), source_data_.size()));
+        populate_workbook();
+
+        return;
+    }
+
+    read(source);
+}
+
+void xlsx_consumer::read(const std::uint8_t *data, std::size_t size, const load_options &options)
+{
+    options_ = options;
+    archive_.reset(new izstream(data, size));
+    populate_workbook();
+}
+
+void xlsx_consumer::read(std::unique_ptr<mapped_file> file, const load_options &options)
+{
+    source_file_ = std::move(file);
+    read(source_file_->data(), source_file_->size(), options);
+}
+
+bool xlsx_consumer::has_deferred_worksheets() const
+{
+    return !deferred_worksheets_.empty();
+}
+
+void xlsx_consumer::read_deferred_worksheet(worksheet_impl *ws)
+{
+    const auto deferred = deferred_worksheets_.find(ws);
+
+    if (deferred == deferred_worksheets_.end())
+    {
+        return;
+    }
+
+    // forgotten first so that the worksheet isn't read again if something
+    // used while reading it looks it up in the workbook
+    deferred_worksheets_.erase(deferred);
+
+    // the workbook may have been moved since it was loaded, and removing
+    // other sheets renumbers the relationship IDs of the rest
+    target_ = ws->parent_;
+    const auto rel_id = target_->d_->sheet_title_rel_id_map_.at(ws->title_);
+
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    const auto worksheet_rel = manifest().relationship(workbook_rel.target().path(), rel_id);
+    const auto part_path = manifest().canonicalize({workbook_rel, worksheet_rel});
+    auto part_streambuf = archive_->open(part_path);
+
+    // a separate consumer keeps the parser state of this one untouched
+    xlsx_consumer worker(*target_);
+    worker.archive_ = archive_;
+
+    if (target_->d_->stylesheet_.is_set())
+    {
+        for (auto &format : target_->d_->stylesheet_.get().format_impls)
+        {
+            worker.formats_.push_back(&format);
+        }
+    }
+
+    worker.read_worksheet_part(worksheet(ws), rel_id, *part_streambuf, part_path.string());
+    worker.finish_worksheet(worksheet(ws), rel_id);
+}
+
+void xlsx_consumer::forget_deferred_worksheet(worksheet_impl *ws)
+{
+    deferred_worksheets_.erase(ws);
+}
+
+void xlsx_consumer::read_deferred_worksheets()
+{
+    if (deferred_worksheets_.empty())
+    {
+        return;
+    }
+
+    // in workbook order, as load would have read them
+    for (auto &ws : (*deferred_worksheets_.begin())->parent_->d_->worksheets_)
+    {
+        read_deferred_worksheet(&ws);
+    }
+}
+
+void xlsx_consumer::open(std::istream &source)
+{
+    streaming_ = true;
+    archive_.reset(new izstream(source));
+    populate_workbook();
+}
+
+std::vector<std::string> xlsx_consumer::sheet_titles() const
+{
+    std::vector<std::string> titles(sheet_title_index_map_.size());
+
+    for (const auto &title_index_pair : sheet_title_index_map_)
+    {
+        titles[title_index_pair.second] = title_index_pair.first;
+    }
+
+    return titles;
+}
+
+void xlsx_consumer::begin_worksheet(const std::string &title)
+{
+    end_worksheet();
+
+    auto rel_id_iter = target_->d_->sheet_title_rel_id_map_.find(title);
+
+    if (rel_id_iter == target_->d_->sheet_title_rel_id_map_.end())
+    {
+        throw key_not_found();
+    }
+
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    const auto sheet_rel = manifest().relationship(workbook_rel.target().path(), rel_id_iter->second);
+    const auto part_path = manifest().canonicalize({workbook_rel, sheet_rel});
+
+    streaming_part_streambuf_ = archive_->open(part_path);
+    streaming_part_stream_.reset(new std::istream(streaming_part_streambuf_.get()));
+    streaming_parser_.reset(new xml::parser(*streaming_part_stream_, part_path.string()));
+    parser_ = streaming_parser_.get();
+    streaming_row_ = 0;
+
+    expect_start_element(qn("spreadsheetml", "worksheet"), xml::content::complex); // CT_Worksheet
+    skip_attributes({qn("mc", "Ignorable")});
+    read_namespaces();
+
+    // skip everything before sheetData (sheetPr, dimension, sheetViews, cols, ...)
+    while (in_element(qn("spreadsheetml", "worksheet")))
+    {
+        auto current_worksheet_element = expect_start_element(xml::content::complex);
+
+        if (current_worksheet_element == qn(sml_element::sheet_data))
+        {
+            return;
+        }
+
+        skip_remaining_content(current_worksheet_element);
+        expect_end_element(current_worksheet_element);
+    }
+
+    // no sheetData element, so there are no rows to read
+    end_worksheet();
+}
+
+bool xlsx_consumer::has_row()
+{
+    return streaming_parser_ != nullptr
+        && in_element(qn(sml_element::sheet_data));
+}
+
+void xlsx_consumer::read_row(streamed_row &row)
+{
+    if (!has_row())
+    {
+        throw xlnt::exception("no more rows in worksheet");
+    }
+
+    expect_start_element(qn(sml_element::row), xml::content::complex); // CT_Row
+
+    // r is optional, in which case the row follows the previous one
+    streaming_row_ = parser().attribute_present("r")
+        ? parser().attribute<row_t>("r")
+        : streaming_row_ + 1;
+    skip_attributes();
+
+    row.index = streaming_row_;
+
+    auto cell_count = std::size_t(0);
+    auto column = column_t::index_t(0);
+
+    while (in_element(qn(sml_element::row)))
+    {
+        expect_start_element(qn(sml_element::c), xml::content::complex); // CT_Cell
+
+        // cells are reused between rows to avoid reallocating their strings
+        if (cell_count == row.cells.size())
+        {
+            row.cells.emplace_back();
+        }
+
+        auto &cell = row.cells[cell_count++];
+
+        if (parser().attribute_present("r"))
+        {
+            cell.reference = cell_reference(parser().attribute("r"));
+            column = cell.reference.column_index();
+        }
+        else
+        {
+            cell.reference = cell_reference(++column, streaming_row_);
+        }
+
+        const auto type = parser().attribute_present("t") ? parser().attribute("t") : std::string("n");
+
+        cell.format_id.clear();
+
+        if (parser().attribute_present("s"))
+        {
+            cell.format_id = static_cast<std::size_t>(std::stoull(parser().attribute("s")));
+        }
+
+        skip_attributes();
+
+        cell.type = cell::type::empty;
+        cell.number = 0;
+        cell.text.clear();
+        cell.formula.clear();
+
+        auto has_value = false;
+        auto value_string = std::string();
+        auto value_number = 0.0L;
+
+        while (in_element(qn(sml_element::c)))
+        {
+            // dispatch on the interned id since this runs for every cell
+            const auto current_element = sml_id(expect_start_element(xml::content::mixed));
+
+            if (current_element == sml_element::v) // s:ST_Xstring
+            {
+                has_value = true;
+
+                if (type == "n" || type == "s")
+                {
+                    value_number = read_number();
+                }
+                else
+                {
+                    value_string = read_text();
+                }
+            }
+            else if (current_element == sml_element::f) // CT_CellFormula
+            {
+                skip_attributes();
+                cell.formula = read_text();
+            }
+            else if (current_element == sml_element::is) // CT_Rst
+            {
+                has_value = true;
+                parser().content(xml::content::complex);
+                expect_start_element(qn(sml_element::t), xml::content::simple);
+                value_string = read_text();
+                expect_end_element(qn(sml_element::t));
+            }
+            else
+            {
+                const auto unexpected = stack_[depth_ - 1];
+                unexpected_element(unexpected);
+                expect_end_element(unexpected);
+                continue;
+            }
+
+            expect_end_element(qn(current_element));
+        }
+
+        expect_end_element(qn(sml_element::c));
+
+        if (!has_value)
+        {
+            continue;
+        }
+
+        if (type == "str")
+        {
+            cell.type = cell::type::formula_string;
+            cell.text = value_string;
+        }
+        else if (type == "inlineStr")
+        {
+            cell.type = cell::type::inline_string;
+            cell.text = value_string;
+        }
+        else if (type == "s")
+        {
+            cell.type = cell::type::shared_string;
+            // read directly since the mutable accessor drops the workbook's lookup index
+            cell.text = target_->d_->shared_strings_.at(static_cast<std::size_t>(value_number)).plain_text();
+        }
+        else if (type == "b") // boolean
+        {
+            cell.type = cell::type::boolean;
+            cell.number = is_true(value_string) ? 1 : 0;
+        }
+        else if (type == "n") // numeric
+        {
+            cell.type = cell::type::number;
+            cell.number = value_number;
+        }
+        else if (!value_string.empty() && value_string[0] == '#')
+        {
+            cell.type = cell::type::error;
+            cell.text = value_string;
+        }
+    }
+
+    row.cells.resize(cell_count);
+
+    expect_end_element(qn(sml_element::row));
+}
+
+void xlsx_consumer::end_worksheet()
+{
+    // The rest of the part doesn't need to be parsed, so the parser
+    // and stream can simply be dropped.
+    parser_ = nullptr;
+    streaming_parser_.reset();
+    streaming_part_stream_.reset();
+    streaming_part_streambuf_.reset();
+    depth_ = 0;
+}
+
 xml::parser &xlsx_consumer::parser()
 {
     return *parser_;
@@ -181,7 +661,7 @@ std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
 
 void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 {
-    const auto &manifest = target_.manifest();
+    const auto &manifest = target_->manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
     auto part_streambuf = archive_->open(part_path);
     std::istream part_stream(part_streambuf.get());
@@ -251,7 +731,7 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
         break;
 
     case relationship_type::worksheet:
-        read_worksheet(rel_chain.back().id());
+        read_worksheet(rel_chain.back().id(), *part_streambuf, part_path.string());
         break;
 
     case relationship_type::thumbnail:
@@ -317,7 +797,7 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 
 void xlsx_consumer::populate_workbook()
 {
-    target_.clear();
+    target_->clear();
 
     read_content_types();
     const auto root_path = path("/");
@@ -354,7 +834,7 @@ void xlsx_consumer::populate_workbook()
 
 void xlsx_consumer::read_content_types()
 {
-    auto &manifest = target_.manifest();
+    auto &manifest = target_->manifest();
     auto content_types_streambuf = archive_->open(path("[Content_Types].xml"));
     std::istream content_types_stream(content_types_streambuf.get());
     xml::parser parser(content_types_stream, "[Content_Types].xml");
@@ -403,7 +883,7 @@ void xlsx_consumer::read_core_properties()
         {
             skip_attribute(qn("xsi", "type"));
         }
-        target_.core_property(prop, read_text());
+        target_->core_property(prop, read_text());
         expect_end_element(property_element);
     }
 
@@ -418,7 +898,7 @@ void xlsx_consumer::read_extended_properties()
     {
         const auto property_element = expect_start_element(xml::content::mixed);
         const auto prop = detail::from_string<extended_property>(property_element.name());
-        target_.extended_property(prop, read_variant());
+        target_->extended_property(prop, read_variant());
         expect_end_element(property_element);
     }
 
@@ -435,7 +915,7 @@ void xlsx_consumer::read_custom_properties()
         const auto prop = parser().attribute("name");
         const auto format_id = parser().attribute("fmtid");
         const auto property_id = parser().attribute("pid");
-        target_.custom_property(prop, read_variant());
+        target_->custom_property(prop, read_variant());
         expect_end_element(property_element);
     }
 
@@ -486,7 +966,7 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
             skip_attribute("codeName");
 
-            target_.d_->file_version_ = file_version;
+            target_->d_->file_version_ = file_version;
         }
         else if (current_workbook_element == qn("workbook", "fileSharing")) // CT_FileSharing 0-1
         {
@@ -494,7 +974,7 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         }
         else if (current_workbook_element == qn("workbook", "workbookPr")) // CT_WorkbookPr 0-1
         {
-            target_.base_date(parser().attribute_present("date1904") // optional, bool=false
+            target_->base_date(parser().attribute_present("date1904") // optional, bool=false
                 && is_true(parser().attribute("date1904"))
                     ? calendar::mac_1904 : calendar::windows_1900);
             skip_attribute("showObjects"); // optional, ST_Objects="all"
@@ -555,7 +1035,7 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
                     view.tab_ratio = parser().attribute<std::size_t>("tabRatio");
                 }
 
-                target_.view(view);
+                target_->view(view);
 
                 skip_attributes();
                 expect_end_element(qn("workbook", "workbookView"));
@@ -574,7 +1054,7 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
                 sheet_title_index_map_[title] = index++;
                 sheet_title_id_map_[title] = parser().attribute<std::size_t>("sheetId");
-                target_.d_->sheet_title_rel_id_map_[title] = parser().attribute(qn("r", "id"));
+                target_->d_->sheet_title_rel_id_map_[title] = parser().attribute(qn("r", "id"));
 
                 expect_end_element(qn("spreadsheetml", "sheet"));
             }
@@ -663,7 +1143,49 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         read_part({workbook_rel, manifest().relationship(workbook_path, relationship_type::theme)});
     }
 
-    for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
+    if (streaming_)
+    {
+        // worksheets are read on demand with begin_worksheet and read_row
+        return;
+    }
+
+    formats_.clear();
+
+    if (target_->d_->stylesheet_.is_set())
+    {
+        for (auto &format : target_->d_->stylesheet_.get().format_impls)
+        {
+            formats_.push_back(&format);
+        }
+    }
+
+    const auto worksheet_rels = manifest().relationships(workbook_path, relationship_type::worksheet);
+
+    if (options_.lazy_worksheets)
+    {
+        // the worksheets are added in order but each is only read when first used
+        for (const auto &worksheet_rel : worksheet_rels)
+        {
+            deferred_worksheets_.insert(create_worksheet(worksheet_rel.id()).d_);
+        }
+
+        return;
+    }
+
+    auto thread_count = options_.worksheet_threads;
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    if (thread_count > 1 && worksheet_rels.size() > 1)
+    {
+        read_worksheets_concurrently({workbook_rel}, worksheet_rels, thread_count);
+        return;
+    }
+
+    for (auto worksheet_rel : worksheet_rels)
     {
         read_part({workbook_rel, worksheet_rel});
     }
@@ -705,7 +1227,7 @@ void xlsx_consumer::read_pivot_table()
 
 void xlsx_consumer::read_shared_string_table()
 {
-    expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
+    expect_start_element(qn(sml_element::sst), xml::content::complex);
     skip_attributes({"count"});
 
     bool has_unique_count = false;
@@ -717,16 +1239,16 @@ void xlsx_consumer::read_shared_string_table()
         unique_count = parser().attribute<std::size_t>("uniqueCount");
     }
 
-    auto &strings = target_.shared_strings();
+    auto &strings = target_->shared_strings();
 
-    while (in_element(qn("spreadsheetml", "sst")))
+    while (in_element(qn(sml_element::sst)))
     {
-        expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
-        strings.push_back(read_rich_text(qn("spreadsheetml", "si")));
-        expect_end_element(qn("spreadsheetml", "si"));
+        expect_start_element(qn(sml_element::si), xml::content::complex);
+        strings.push_back(read_rich_text(qn(sml_element::si)));
+        expect_end_element(qn(sml_element::si));
     }
 
-    expect_end_element(qn("spreadsheetml", "sst"));
+    expect_end_element(qn(sml_element::sst));
 
     if (has_unique_count && unique_count != strings.size())
     {
@@ -748,8 +1270,8 @@ void xlsx_consumer::read_shared_workbook_user_data()
 
 void xlsx_consumer::read_stylesheet()
 {
-    target_.impl().stylesheet_ = detail::stylesheet();
-    auto &stylesheet = target_.impl().stylesheet_.get();
+    target_->impl().stylesheet_ = detail::stylesheet();
+    auto &stylesheet = target_->impl().stylesheet_.get();
 
     expect_start_element(qn("spreadsheetml", "styleSheet"), xml::content::complex);
     skip_attributes({qn("mc", "Ignorable")});
@@ -1370,6 +1892,9 @@ void xlsx_consumer::read_stylesheet()
         new_format.pivot_button_ = record.first.pivot_button_;
         new_format.quote_prefix_ = record.first.quote_prefix_;
     }
+
+    // items above were filled in after being appended
+    stylesheet.clear_indices();
 }
 
 void xlsx_consumer::read_theme()
@@ -1378,7 +1903,7 @@ void xlsx_consumer::read_theme()
     auto theme_rel = manifest().relationship(workbook_rel.target().path(), relationship_type::theme);
     auto theme_path = manifest().canonicalize({workbook_rel, theme_rel});
 
-    target_.theme(theme());
+    target_->theme(theme());
 
     if (manifest().has_relationship(theme_path, relationship_type::image))
     {
@@ -1391,39 +1916,111 @@ void xlsx_consumer::read_volatile_dependencies()
 }
 
 // CT_Worksheet
-void xlsx_consumer::read_worksheet(const std::string &rel_id)
+void xlsx_consumer::read_worksheet(const std::string &rel_id, std::streambuf &part, const std::string &part_name)
 {
-/*
-    static const auto &xmlns = constants::namespace_("spreadsheetml");
-    static const auto &xmlns_mc = constants::namespace_("mc");
-    static const auto &xmlns_x14ac = constants::namespace_("x14ac");
-    static const auto &xmlns_r = constants::namespace_("r");
-*/
-    auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
-        target_.d_->sheet_title_rel_id_map_.end(),
-        [&](const std::pair<std::string, std::string> &p) {
-            return p.second == rel_id;
-        })->first;
+    auto ws = create_worksheet(rel_id);
+    read_worksheet_part(ws, rel_id, part, part_name);
+    finish_worksheet(ws, rel_id);
+}
 
-    auto id = sheet_title_id_map_[title];
-    auto index = sheet_title_index_map_[title];
+void xlsx_consumer::read_worksheets_concurrently(const std::vector<relationship> &rel_chain_prefix,
+    const std::vector<relationship> &worksheet_rels, std::size_t thread_count)
+{
+    std::vector<worksheet> worksheets;
+    std::vector<path> part_paths;
+    std::vector<std::unique_ptr<std::streambuf>> part_streambufs;
 
-    auto insertion_iter = target_.d_->worksheets_.begin();
-    while (insertion_iter != target_.d_->worksheets_.end() && sheet_title_index_map_[insertion_iter->title_] < index)
+    // the workbook's sheet list and the archive's stream can only be used from this thread
+    for (const auto &worksheet_rel : worksheet_rels)
     {
-        ++insertion_iter;
+        auto rel_chain = rel_chain_prefix;
+        rel_chain.push_back(worksheet_rel);
+
+        worksheets.push_back(create_worksheet(worksheet_rel.id()));
+        part_paths.push_back(manifest().canonicalize(rel_chain));
+        part_streambufs.push_back(archive_->open_detached(part_paths.back()));
     }
 
-    target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
+    std::atomic<std::size_t> next_worksheet(0);
+    std::vector<std::exception_ptr> errors(worksheets.size());
+    std::vector<std::vector<range_reference>> merged_cells(worksheets.size());
 
-    auto ws = target_.sheet_by_id(id);
+    auto read_worksheets = [&]() {
+        for (auto i = next_worksheet++; i < worksheets.size(); i = next_worksheet++)
+        {
+            try
+            {
+                xlsx_consumer worker(*target_);
+                worker.formats_ = formats_;
+                worker.read_worksheet_part(worksheets[i], worksheet_rels[i].id(),
+                    *part_streambufs[i], part_paths[i].string());
+                merged_cells[i] = std::move(worker.merged_cells_);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+
+            part_streambufs[i].reset();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < std::min(thread_count, worksheets.size()); ++i)
+    {
+        threads.emplace_back(read_worksheets);
+    }
+
+    read_worksheets();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < worksheets.size(); ++i)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
 
+        merged_cells_ = std::move(merged_cells[i]);
+        finish_worksheet(worksheets[i], worksheet_rels[i].id());
+    }
+}
+
+worksheet xlsx_consumer::create_worksheet(const std::string &rel_id)
+{
+    auto title = std::find_if(target_->d_->sheet_title_rel_id_map_.begin(),
+        target_->d_->sheet_title_rel_id_map_.end(),
+        [&](const std::pair<std::string, std::string> &p) {
+            return p.second == rel_id;
+        })->first;
+
+    auto id = sheet_title_id_map_[title];
+    auto index = sheet_title_index_map_[title];
+
+    auto insertion_iter = target_->d_->worksheets_.begin();
+    while (insertion_iter != target_->d_->worksheets_.end() && sheet_title_index_map_[insertion_iter->title_] < index)
+    {
+        ++insertion_iter;
+    }
+
+    target_->d_->worksheets_.emplace(insertion_iter, target_, id, title);
+
+    return target_->sheet_by_id(id);
+}
+
+void xlsx_consumer::read_worksheet_contents(worksheet ws, const std::string &rel_id)
+{
     expect_start_element(qn("spreadsheetml", "worksheet"), xml::content::complex); // CT_Worksheet
     skip_attributes({qn("mc", "Ignorable")});
     read_namespaces();
 
     xlnt::range_reference full_range;
-    auto &manifest = target_.manifest();
+    auto &manifest = target_->manifest();
 
     const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
     const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
@@ -1622,16 +2219,30 @@ void xlsx_consumer::read_worksheet(const std::string &rel_id)
                 }
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sheetData")) // CT_SheetData 1
+        else if (current_worksheet_element == qn(sml_element::sheet_data)) // CT_SheetData 1
         {
-            while (in_element(qn("spreadsheetml", "sheetData")))
+            auto row_index = row_t(0);
+
+            while (in_element(qn(sml_element::sheet_data)))
             {
-                expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-                auto row_index = parser().attribute<row_t>("r");
+                expect_start_element(qn(sml_element::row), xml::content::complex); // CT_Row
+
+                // r is optional, in which case the row follows the previous one
+                row_index = parser().attribute_present("r")
+                    ? parser().attribute<row_t>("r")
+                    : row_index + 1;
 
                 if (parser().attribute_present("ht"))
                 {
-                    ws.row_properties(row_index).height = parser().attribute<double>("ht");
+                    const auto &height = parser().attribute("ht");
+                    auto height_value = 0.0L;
+
+                    if (!parse_xml_number(height.data(), height.data() + height.size(), height_value))
+                    {
+                        throw invalid_file("invalid row height " + height);
+                    }
+
+                    ws.row_properties(row_index).height = static_cast<double>(height_value);
                 }
 
                 if (parser().attribute_present("customHeight"))
@@ -1644,111 +2255,113 @@ void xlsx_consumer::read_worksheet(const std::string &rel_id)
                     ws.row_properties(row_index).hidden = true;
                 }
 
-                skip_attributes({qn("x14ac", "dyDescent")});
-                skip_attributes({"customFormat", "s", "customFont",
-                    "outlineLevel", "collapsed", "thickTop", "thickBot",
-                    "ph", "spans"});
+                static const auto ignored_row_attributes = std::vector<std::string>{"customFormat", "s",
+                    "customFont", "outlineLevel", "collapsed", "thickTop", "thickBot", "ph", "spans"};
+                static const auto dy_descent = qn("x14ac", "dyDescent");
+
+                skip_attribute(dy_descent);
+                skip_attributes(ignored_row_attributes);
+
+                // cells are written in order so each one normally follows the previous
+                // one in this row and is appended to the row without any searching
+                auto column_index = column_t::index_t(0);
 
-                while (in_element(qn("spreadsheetml", "row")))
+                while (in_element(qn(sml_element::row)))
                 {
-                    expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
-                    auto cell = ws.cell(cell_reference(parser().attribute("r")));
+                    expect_start_element(qn(sml_element::c), xml::content::complex);
 
-                    auto has_type = parser().attribute_present("t");
-                    auto type = has_type ? parser().attribute("t") : "n";
+                    auto cell_row = row_index;
 
-                    auto has_format = parser().attribute_present("s");
-                    auto format_id = static_cast<std::size_t>(has_format ? std::stoull(parser().attribute("s")) : 0LL);
+                    // r is optional, in which case the cell follows the previous one
+                    if (parser().attribute_present("r"))
+                    {
+                        const auto &reference_string = parser().attribute("r");
+                        const auto reference = cell_reference::from_chars(
+                            reference_string.data(), reference_string.data() + reference_string.size());
+                        cell_row = reference.row();
+                        column_index = reference.column_index();
+                    }
+                    else
+                    {
+                        ++column_index;
+                    }
 
-                    auto has_value = false;
-                    auto value_string = std::string();
+                    auto emplaced = ws.d_->cells_.emplace(cell_row, column_index);
+
+                    if (emplaced.second)
+                    {
+                        emplaced.first->parent_ = ws.d_;
+                    }
+
+                    auto fields = cell_fields();
+
+                    if (parser().attribute_present("t"))
+                    {
+                        fields.type = parser().attribute("t");
+                    }
 
-                    auto has_formula = false;
-                    auto has_shared_formula = false;
-                    auto formula_value_string = std::string();
+                    fields.has_format = parser().attribute_present("s");
+                    fields.format_id = static_cast<std::size_t>(fields.has_format ? std::stoull(parser().attribute("s")) : 0LL);
 
-                    while (in_element(qn("spreadsheetml", "c")))
+                    while (in_element(qn(sml_element::c)))
                     {
-                        auto current_element = expect_start_element(xml::content::mixed);
+                        // dispatch on the interned id since this runs for every cell
+                        const auto current_element = sml_id(expect_start_element(xml::content::mixed));
 
-                        if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
+                        if (current_element == sml_element::v) // s:ST_Xstring
                         {
-                            has_value = true;
-                            value_string = read_text();
+                            fields.has_value = true;
+
+                            if (fields.type == "n" || fields.type == "s")
+                            {
+                                fields.value_number = read_number();
+                            }
+                            else
+                            {
+                                fields.value_string = read_text();
+                            }
                         }
-                        else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
+                        else if (current_element == sml_element::f) // CT_CellFormula
                         {
-                            has_formula = true;
+                            fields.has_formula = true;
 
                             if (parser().attribute_present("t"))
                             {
-                                has_shared_formula = parser().attribute("t") == "shared";
+                                fields.has_shared_formula = parser().attribute("t") == "shared";
                             }
 
-                            skip_attributes(
-                                {"aca", "ref", "dt2D", "dtr", "del1", "del2", "r1", "r2", "ca", "si", "bx"});
+                            static const auto ignored_formula_attributes = std::vector<std::string>{
+                                "aca", "ref", "dt2D", "dtr", "del1", "del2", "r1", "r2", "ca", "si", "bx"};
+
+                            skip_attributes(ignored_formula_attributes);
 
-                            formula_value_string = read_text();
+                            fields.formula_value_string = read_text();
                         }
-                        else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
+                        else if (current_element == sml_element::is) // CT_Rst
                         {
-                            expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
-                            value_string = read_text();
-                            expect_end_element(qn("spreadsheetml", "t"));
+                            fields.has_value = true;
+                            parser().content(xml::content::complex);
+                            expect_start_element(qn(sml_element::t), xml::content::simple);
+                            fields.value_string = read_text();
+                            expect_end_element(qn(sml_element::t));
                         }
                         else
                         {
-                            unexpected_element(current_element);
+                            const auto unexpected = stack_[depth_ - 1];
+                            unexpected_element(unexpected);
+                            expect_end_element(unexpected);
+                            continue;
                         }
 
-                        expect_end_element(current_element);
+                        expect_end_element(qn(current_element));
                     }
 
-                    expect_end_element(qn("spreadsheetml", "c"));
+                    expect_end_element(qn(sml_element::c));
 
-                    if (has_formula && !has_shared_formula)
-                    {
-                        cell.formula(formula_value_string);
-                    }
-
-                    if (has_value)
-                    {
-                        if (type == "str")
-                        {
-                            cell.d_->value_text_ = value_string;
-                            cell.data_type(cell::type::formula_string);
-                        }
-                        else if (type == "inlineStr")
-                        {
-                            cell.d_->value_text_ = value_string;
-                            cell.data_type(cell::type::inline_string);
-                        }
-                        else if (type == "s")
-                        {
-                            cell.d_->value_numeric_ = std::stold(value_string);
-                            cell.data_type(cell::type::shared_string);
-                        }
-                        else if (type == "b") // boolean
-                        {
-                            cell.value(is_true(value_string));
-                        }
-                        else if (type == "n") // numeric
-                        {
-                            cell.value(std::stold(value_string));
-                        }
-                        else if (!value_string.empty() && value_string[0] == '#')
-                        {
-                            cell.error(value_string);
-                        }
-                    }
-
-                    if (has_format)
-                    {
-                        cell.format(target_.format(format_id));
-                    }
+                    store_cell(xlnt::cell(emplaced.first), fields);
                 }
 
-                expect_end_element(qn("spreadsheetml", "row"));
+                expect_end_element(qn(sml_element::row));
             }
         }
         else if (current_worksheet_element == qn("spreadsheetml", "sheetCalcPr")) // CT_SheetCalcPr 0-1
@@ -1792,7 +2405,7 @@ void xlsx_consumer::read_worksheet(const std::string &rel_id)
             while (in_element(qn("spreadsheetml", "mergeCells")))
             {
                 expect_start_element(qn("spreadsheetml", "mergeCell"), xml::content::simple);
-                ws.merge_cells(range_reference(parser().attribute("ref")));
+                merged_cells_.push_back(range_reference(parser().attribute("ref")));
                 expect_end_element(qn("spreadsheetml", "mergeCell"));
 
                 count--;
@@ -2045,6 +2658,385 @@ void xlsx_consumer::read_worksheet(const std::string &rel_id)
     }
 
     expect_end_element(qn("spreadsheetml", "worksheet"));
+}
+
+void xlsx_consumer::read_worksheet_part(worksheet ws, const std::string &rel_id,
+    std::streambuf &part, const std::string &part_name)
+{
+    const auto text = read_all(part);
+    const auto first = text.data();
+    const auto last = first + text.size();
+
+    // the rows are read by the tokenizer and xml::parser reads the rest of the
+    // part with an empty sheetData element in their place
+    auto remainder = std::string();
+    auto bounds = sheet_data_bounds();
+
+    if (find_sheet_data(first, last, bounds))
+    {
+        sheet_data_tokenizer tokens(bounds.content_first, bounds.content_last);
+
+        if (read_sheet_data(ws, tokens))
+        {
+            remainder.reserve(static_cast<std::size_t>((bounds.element_first - first) + (last - bounds.element_last)) + 12);
+            remainder.append(first, bounds.element_first);
+            remainder.append("<sheetData/>");
+            remainder.append(bounds.element_last, last);
+        }
+    }
+
+    // otherwise everything is read by xml::parser, which stores the same
+    // values again in any cells that the tokenizer had already read
+    const auto &document = remainder.empty() ? text : remainder;
+    xml::parser parser(document.data(), document.size(), part_name);
+
+    const auto previous_parser = parser_;
+    parser_ = &parser;
+    read_worksheet_contents(ws, rel_id);
+    parser_ = previous_parser;
+}
+
+bool xlsx_consumer::read_sheet_data(worksheet ws, sheet_data_tokenizer &tokens)
+{
+    using range = sheet_data_tokenizer::range;
+
+    auto name = range();
+    auto value = range();
+    auto number = std::uint64_t(0);
+    auto row_index = row_t(0);
+    auto fields = cell_fields();
+
+    while (!tokens.at_end())
+    {
+        if (!tokens.start_tag("row")) // CT_Row
+        {
+            return false;
+        }
+
+        // attributes can be in any order, so they are only applied once all are read
+        auto height = range();
+        auto custom_height = range();
+        auto hidden = range();
+        auto has_index = false;
+
+        while (tokens.attribute(name, value))
+        {
+            if (name == "r")
+            {
+                if (!sheet_data_tokenizer::to_unsigned(value, number)
+                    || number > std::numeric_limits<row_t>::max())
+                {
+                    return false;
+                }
+
+                has_index = true;
+                row_index = static_cast<row_t>(number);
+            }
+            else if (name == "ht")
+            {
+                height = value;
+            }
+            else if (name == "customHeight")
+            {
+                custom_height = value;
+            }
+            else if (name == "hidden")
+            {
+                hidden = value;
+            }
+            else if (!(name == "spans" || name == "s" || name == "customFormat" || name == "customFont"
+                || name == "outlineLevel" || name == "collapsed" || name == "thickTop" || name == "thickBot"
+                || name == "ph" || name == "x14ac:dyDescent" || name == "xml:space"))
+            {
+                return false;
+            }
+        }
+
+        if (tokens.failed())
+        {
+            return false;
+        }
+
+        // r is optional, in which case the row follows the previous one
+        if (!has_index)
+        {
+            ++row_index;
+        }
+
+        if (height.first != nullptr)
+        {
+            auto height_value = 0.0L;
+
+            if (!parse_xml_number(height.first, height.last, height_value))
+            {
+                return false;
+            }
+
+            ws.row_properties(row_index).height = static_cast<double>(height_value);
+        }
+
+        if (custom_height.first != nullptr)
+        {
+            ws.row_properties(row_index).custom_height = is_true(std::string(custom_height.first, custom_height.last));
+        }
+
+        if (hidden.first != nullptr && is_true(std::string(hidden.first, hidden.last)))
+        {
+            ws.row_properties(row_index).hidden = true;
+        }
+
+        if (tokens.empty_element())
+        {
+            continue;
+        }
+
+        auto column_index = column_t::index_t(0);
+
+        while (!tokens.end_tag("row"))
+        {
+            if (!tokens.start_tag("c")) // CT_Cell
+            {
+                return false;
+            }
+
+            auto cell_row = row_index;
+            auto has_reference = false;
+
+            fields.type = "n";
+            fields.has_format = false;
+            fields.format_id = 0;
+            fields.has_value = false;
+            fields.has_formula = false;
+            fields.has_shared_formula = false;
+            fields.formula_value_string.clear();
+
+            while (tokens.attribute(name, value))
+            {
+                if (name == "r")
+                {
+                    const auto reference = cell_reference::from_chars(value.first, value.last);
+                    cell_row = reference.row();
+                    column_index = reference.column_index();
+                    has_reference = true;
+                }
+                else if (name == "t")
+                {
+                    fields.type.assign(value.first, value.last);
+                }
+                else if (name == "s")
+                {
+                    if (!sheet_data_tokenizer::to_unsigned(value, number))
+                    {
+                        return false;
+                    }
+
+                    fields.has_format = true;
+                    fields.format_id = static_cast<std::size_t>(number);
+                }
+                else if (!(name == "xml:space"))
+                {
+                    return false;
+                }
+            }
+
+            if (tokens.failed())
+            {
+                return false;
+            }
+
+            // r is optional, in which case the cell follows the previous one
+            if (!has_reference)
+            {
+                ++column_index;
+            }
+
+            auto emplaced = ws.d_->cells_.emplace(cell_row, column_index);
+
+            if (emplaced.second)
+            {
+                emplaced.first->parent_ = ws.d_;
+            }
+
+            const auto empty_cell = tokens.empty_element();
+
+            while (!empty_cell && !tokens.end_tag("c"))
+            {
+                if (tokens.start_tag("v")) // s:ST_Xstring
+                {
+                    while (tokens.attribute(name, value))
+                    {
+                        if (!(name == "xml:space"))
+                        {
+                            return false;
+                        }
+                    }
+
+                    fields.has_value = true;
+                    fields.value_string.clear();
+
+                    if (tokens.failed() || (!tokens.empty_element()
+                        && (!tokens.text(fields.value_string) || !tokens.end_tag("v"))))
+                    {
+                        return false;
+                    }
+
+                    if (fields.type == "n" || fields.type == "s")
+                    {
+                        const auto &text = fields.value_string;
+
+                        if (!parse_xml_number(text.data(), text.data() + text.size(), fields.value_number))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                else if (tokens.start_tag("f")) // CT_CellFormula
+                {
+                    while (tokens.attribute(name, value))
+                    {
+                        if (name == "t")
+                        {
+                            fields.has_shared_formula = value == "shared";
+                        }
+                        else if (!(name == "aca" || name == "ref" || name == "dt2D" || name == "dtr"
+                            || name == "del1" || name == "del2" || name == "r1" || name == "r2"
+                            || name == "ca" || name == "si" || name == "bx" || name == "xml:space"))
+                        {
+                            return false;
+                        }
+                    }
+
+                    fields.has_formula = true;
+                    fields.formula_value_string.clear();
+
+                    if (tokens.failed() || (!tokens.empty_element()
+                        && (!tokens.text(fields.formula_value_string) || !tokens.end_tag("f"))))
+                    {
+                        return false;
+                    }
+                }
+                else if (tokens.start_tag("is")) // CT_Rst
+                {
+                    // only a single run of plain text is handled here
+                    fields.has_value = true;
+                    fields.value_string.clear();
+
+                    if (tokens.attribute(name, value) || tokens.failed() || tokens.empty_element()
+                        || !tokens.start_tag("t"))
+                    {
+                        return false;
+                    }
+
+                    while (tokens.attribute(name, value))
+                    {
+                        if (!(name == "xml:space"))
+                        {
+                            return false;
+                        }
+                    }
+
+                    if (tokens.failed() || (!tokens.empty_element()
+                        && (!tokens.text(fields.value_string) || !tokens.end_tag("t")))
+                        || !tokens.end_tag("is"))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            store_cell(xlnt::cell(emplaced.first), fields);
+        }
+    }
+
+    return true;
+}
+
+void xlsx_consumer::store_cell(cell cell, const cell_fields &fields)
+{
+    if (fields.has_formula && !fields.has_shared_formula && !fields.formula_value_string.empty())
+    {
+        // cell::formula would register the calculation chain,
+        // that's left to finish_worksheet
+        cell.d_->formula(fields.formula_value_string);
+        cell.data_type(cell::type::number);
+    }
+
+    if (fields.has_value)
+    {
+        if (fields.type == "str")
+        {
+            cell.d_->value_text(rich_text(fields.value_string));
+            cell.data_type(cell::type::formula_string);
+        }
+        else if (fields.type == "inlineStr")
+        {
+            cell.d_->value_text(rich_text(fields.value_string));
+            cell.data_type(cell::type::inline_string);
+        }
+        else if (fields.type == "s")
+        {
+            cell.d_->value_numeric_ = fields.value_number;
+            cell.data_type(cell::type::shared_string);
+        }
+        else if (fields.type == "b") // boolean
+        {
+            cell.value(is_true(fields.value_string));
+        }
+        else if (fields.type == "n") // numeric
+        {
+            cell.value(fields.value_number);
+        }
+        else if (!fields.value_string.empty() && fields.value_string[0] == '#')
+        {
+            cell.error(fields.value_string);
+        }
+    }
+
+    if (fields.has_format)
+    {
+        if (fields.format_id >= formats_.size())
+        {
+            throw key_not_found();
+        }
+
+        // reference counts are updated in finish_worksheet
+        cell.d_->format_ = formats_[fields.format_id];
+    }
+}
+
+void xlsx_consumer::finish_worksheet(worksheet ws, const std::string &rel_id)
+{
+    for (const auto &merged_range : merged_cells_)
+    {
+        ws.merge_cells(merged_range);
+    }
+
+    merged_cells_.clear();
+
+    for (const auto &row : ws.d_->cells_.rows())
+    {
+        for (const auto &cell : row.cells)
+        {
+            if (cell.impl->format_ != nullptr)
+            {
+                ++cell.impl->format_->references;
+            }
+        }
+    }
+
+    if (!ws.d_->formulae_.empty())
+    {
+        ws.register_calc_chain_in_manifest();
+    }
+
+    auto &manifest = target_->manifest();
+    const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
+    const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
+    path sheet_path(sheet_rel.source().path().parent().append(sheet_rel.target().path()));
 
     if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
     {
@@ -2144,7 +3136,7 @@ void xlsx_consumer::read_unknown_relationships()
 void xlsx_consumer::read_image(const xlnt::path &image_path)
 {
     auto image_streambuf = archive_->open(image_path);
-    vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
+    vector_ostreambuf buffer(target_->d_->images_[image_path.string()]);
     std::ostream out_stream(&buffer);
     out_stream << image_streambuf.get();
 }
@@ -2162,11 +3154,32 @@ std::string xlsx_consumer::read_text()
     return text;
 }
 
+long double xlsx_consumer::read_number()
+{
+    parser().content(xml::content::simple);
+
+    if (parser().peek() != xml::parser::event_type::characters)
+    {
+        throw invalid_file("missing number");
+    }
+
+    parser().next_expect(xml::parser::event_type::characters);
+    const auto &text = parser().value();
+    auto number = 0.0L;
+
+    if (!parse_xml_number(text.data(), text.data() + text.size(), number))
+    {
+        throw invalid_file("invalid number " + text);
+    }
+
+    return number;
+}
+
 variant xlsx_consumer::read_variant()
 {
     auto value = variant(read_text());
 
-    if (in_element(stack_.back()))
+    if (in_element(stack_[depth_ - 1]))
     {
         auto element = expect_start_element(xml::content::mixed);
         auto text = read_text();
@@ -2298,29 +3311,41 @@ std::vector<std::string> xlsx_consumer::read_namespaces()
 bool xlsx_consumer::in_element(const xml::qname &name)
 {
     return parser().peek() != xml::parser::event_type::end_element
-        && stack_.back() == name;
+        && stack_[depth_ - 1] == name;
 }
 
-xml::qname xlsx_consumer::expect_start_element(xml::content content)
+const xml::qname &xlsx_consumer::expect_start_element(xml::content content)
 {
     parser().next_expect(xml::parser::event_type::start_element);
     parser().content(content);
-    stack_.push_back(parser().qname());
+    push_element(parser().qname());
 
-    const auto xml_space = qn("xml", "space");
-    preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
+    preserve_space_ = parser().attribute_present(xml_space()) ? parser().attribute(xml_space()) == "preserve" : false;
 
-    return stack_.back();
+    return stack_[depth_ - 1];
 }
 
 void xlsx_consumer::expect_start_element(const xml::qname &name, xml::content content)
 {
     parser().next_expect(xml::parser::event_type::start_element, name);
     parser().content(content);
-    stack_.push_back(name);
+    push_element(name);
 
-    const auto xml_space = qn("xml", "space");
-    preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
+    preserve_space_ = parser().attribute_present(xml_space()) ? parser().attribute(xml_space()) == "preserve" : false;
+}
+
+void xlsx_consumer::push_element(const xml::qname &name)
+{
+    if (depth_ < stack_.size())
+    {
+        stack_[depth_] = name;
+    }
+    else
+    {
+        stack_.push_back(name);
+    }
+
+    ++depth_;
 }
 
 void xlsx_consumer::expect_end_element(const xml::qname &name)
@@ -2332,7 +3357,7 @@ void xlsx_consumer::expect_end_element(const xml::qname &name)
         parser().next_expect(xml::parser::event_type::end_namespace_decl);
     }
 
-    stack_.pop_back();
+    --depth_;
 }
 
 rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
@@ -2342,19 +3367,20 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
     while (in_element(parent))
     {
-        auto text_element = expect_start_element(xml::content::mixed);
+        // plain strings are read for every shared string so they're matched by interned id
+        const auto text_id = sml_id(expect_start_element(xml::content::mixed));
         skip_attributes();
         auto text = read_text();
 
-        if (text_element == xml::qname(xmlns, "t"))
+        if (text_id == sml_element::t)
         {
             t.plain_text(text);
         }
-        else if (text_element == xml::qname(xmlns, "r"))
+        else if (text_id == sml_element::r)
         {
             rich_text_run run;
 
-            while (in_element(xml::qname(xmlns, "r")))
+            while (in_element(qn(sml_element::r)))
             {
                 auto run_element = expect_start_element(xml::content::mixed);
                 auto run_text = read_text();
@@ -2421,7 +3447,7 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
                         read_text();
                     }
                 }
-                else if (run_element == xml::qname(xmlns, "t"))
+                else if (sml_id(run_element) == sml_element::t)
                 {
                     run.first = run_text;
                 }
@@ -2437,21 +3463,26 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
             t.add_run(run);
         }
-        else if (text_element == xml::qname(xmlns, "rPh"))
-        {
-            skip_remaining_content(text_element);
-        }
-        else if (text_element == xml::qname(xmlns, "phoneticPr"))
-        {
-            skip_remaining_content(text_element);
-        }
         else
         {
-            unexpected_element(text_element);
+            const auto text_element = stack_[depth_ - 1];
+
+            if (text_element == xml::qname(xmlns, "rPh") || text_element == xml::qname(xmlns, "phoneticPr"))
+            {
+                skip_remaining_content(text_element);
+            }
+            else
+            {
+                unexpected_element(text_element);
+            }
+
+            read_text();
+            expect_end_element(text_element);
+            continue;
         }
 
         read_text();
-        expect_end_element(text_element);
+        expect_end_element(qn(text_id));
     }
 
     return t;
@@ -2490,7 +3521,7 @@ xlnt::color xlsx_consumer::read_color()
 
 manifest &xlsx_consumer::manifest()
 {
-    return target_.manifest();
+    return target_->manifest();
 }
 
 } // namespace detail
@@ -28,14 +28,20 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/worksheet/range_reference.hpp>
 
 namespace xlnt {
 
+class cell;
 class color;
 class rich_text;
 class manifest;
@@ -45,9 +51,15 @@ class variant;
 class workbook;
 class worksheet;
 
+struct streamed_row;
+
 namespace detail {
 
 class izstream;
+class mapped_file;
+class sheet_data_tokenizer;
+struct format_impl;
+struct worksheet_impl;
 
 /// <summary>
 /// Handles writing a workbook into an XLSX file.
@@ -57,11 +69,112 @@ class xlsx_consumer
 public:
 	xlsx_consumer(workbook &destination);
 
+    /// <summary>
+    /// Releases the archive and any file or data kept for deferred worksheets.
+    /// </summary>
+    ~xlsx_consumer();
+
 	void read(std::istream &source);
 
 	void read(std::istream &source, const std::string &password);
 
+    /// <summary>
+    /// Reads the workbook from source as read(source) does, using the given options.
+    /// </summary>
+    void read(std::istream &source, const load_options &options);
+
+    /// <summary>
+    /// Reads the workbook from the archive of the given size held in memory at
+    /// data, such as a mapped file, using the given options. Parts are inflated
+    /// directly from that memory rather than being read through a stream.
+    /// </summary>
+    void read(const std::uint8_t *data, std::size_t size, const load_options &options);
+
+    /// <summary>
+    /// Reads the workbook from file as read(data, size, options) does. The file
+    /// is kept mapped for as long as this consumer exists so that worksheets
+    /// left unread by load_options::lazy_worksheets can be read from it later.
+    /// </summary>
+    void read(std::unique_ptr<mapped_file> file, const load_options &options);
+
+    // Lazy worksheets
+
+    /// <summary>
+    /// Returns true if any worksheet left unread by load_options::lazy_worksheets
+    /// hasn't been read yet.
+    /// </summary>
+    bool has_deferred_worksheets() const;
+
+    /// <summary>
+    /// Reads the worksheet ws if it was left unread by load_options::lazy_worksheets.
+    /// Otherwise does nothing.
+    /// </summary>
+    void read_deferred_worksheet(worksheet_impl *ws);
+
+    /// <summary>
+    /// Forgets the worksheet ws, which is being removed from the workbook, if
+    /// it was left unread by load_options::lazy_worksheets.
+    /// </summary>
+    void forget_deferred_worksheet(worksheet_impl *ws);
+
+    /// <summary>
+    /// Reads every worksheet that was left unread by load_options::lazy_worksheets
+    /// in workbook order.
+    /// </summary>
+    void read_deferred_worksheets();
+
+    // Streaming
+
+    /// <summary>
+    /// Read everything from source that is needed to stream worksheets one at a
+    /// time (package parts, workbook part, shared strings, stylesheet, theme)
+    /// without reading any worksheet parts.
+    /// </summary>
+    void open(std::istream &source);
+
+    /// <summary>
+    /// Returns the titles of the worksheets in the opened file in workbook order.
+    /// </summary>
+    std::vector<std::string> sheet_titles() const;
+
+    /// <summary>
+    /// Opens the worksheet part for the sheet with the given title and parses
+    /// it up to the first row of its sheetData element.
+    /// </summary>
+    void begin_worksheet(const std::string &title);
+
+    /// <summary>
+    /// Returns true if another row can be read from the current worksheet.
+    /// </summary>
+    bool has_row();
+
+    /// <summary>
+    /// Reads the next row of the current worksheet into row, replacing its contents.
+    /// </summary>
+    void read_row(streamed_row &row);
+
+    /// <summary>
+    /// Releases the parser and archive stream of the current worksheet.
+    /// </summary>
+    void end_worksheet();
+
 private:
+    /// <summary>
+    /// The parts of a c element that are needed to store its cell.
+    /// </summary>
+    struct cell_fields
+    {
+        std::string type = "n";
+        bool has_format = false;
+        std::size_t format_id = 0;
+        bool has_value = false;
+        std::string value_string;
+        long double value_number = 0;
+        bool has_formula = false;
+        bool has_shared_formula = false;
+        std::string formula_value_string;
+    };
+
 	/// <summary>
 	/// Read all the files needed from the XLSX archive and initialize all of
 	/// the data in the workbook to match.
@@ -178,7 +291,58 @@ private:
 	/// <summary>
 	/// xl/sheets/*.xml
 	/// </summary>
-	void read_worksheet(const std::string &title);
+	void read_worksheet(const std::string &rel_id, std::streambuf &part, const std::string &part_name);
+
+    /// <summary>
+    /// Reads the worksheet parts targeted by worksheet_rels, each relative to
+    /// rel_chain_prefix, using up to thread_count threads. Parts are copied
+    /// out of the archive on this thread and then decompressed and parsed
+    /// concurrently into the worksheets, which are finished in sheet order.
+    /// </summary>
+    void read_worksheets_concurrently(const std::vector<relationship> &rel_chain_prefix,
+        const std::vector<relationship> &worksheet_rels, std::size_t thread_count);
+
+    /// <summary>
+    /// Adds the worksheet with the given relationship ID to the workbook in
+    /// its proper position and returns it.
+    /// </summary>
+    worksheet create_worksheet(const std::string &rel_id);
+
+    /// <summary>
+    /// Parses the CT_Worksheet document from the current parser into ws.
+    /// Nothing outside of ws is modified, so this can be called for different
+    /// worksheets on different threads. Merged ranges are only collected in
+    /// merged_cells_.
+    /// </summary>
+    void read_worksheet_contents(worksheet ws, const std::string &rel_id);
+
+    /// <summary>
+    /// Reads the worksheet part in part, named part_name, into ws as
+    /// read_worksheet_contents does. The part is decompressed into memory so
+    /// that its rows can be read by read_sheet_data, leaving only the rest of
+    /// it to xml::parser.
+    /// </summary>
+    void read_worksheet_part(worksheet ws, const std::string &rel_id,
+        std::streambuf &part, const std::string &part_name);
+
+    /// <summary>
+    /// Reads the rows of a sheetData element from tokens into ws. Returns false
+    /// if the tokenizer fails, in which case the whole part should be read again
+    /// by read_worksheet_contents.
+    /// </summary>
+    bool read_sheet_data(worksheet ws, sheet_data_tokenizer &tokens);
+
+    /// <summary>
+    /// Sets the value, formula and format of cell from the fields of its c element.
+    /// </summary>
+    void store_cell(cell cell, const cell_fields &fields);
+
+    /// <summary>
+    /// Updates the workbook after read_worksheet_contents: merges the cells in
+    /// merged_cells_, counts references to formats, registers the calculation
+    /// chain if ws has formulae, and reads comments.
+    /// </summary>
+    void finish_worksheet(worksheet ws, const std::string &rel_id);
 
 	// Sheet Relationship Target Parts
 
@@ -250,6 +414,14 @@ private:
     /// </summary>
     std::string read_text();
 
+    /// <summary>
+    /// Reads the character data of the current element as a number. The element's
+    /// content is made simple so that the parser delivers all of the text at once
+    /// and it is parsed in the parser's buffer without being copied. Throws
+    /// invalid_file if the text isn't a number.
+    /// </summary>
+    long double read_number();
+
     variant read_variant();
 
     /// <summary>
@@ -297,9 +469,10 @@ private:
     /// <summary>
     /// Handles the next event in the XML parser and throws an exception
     /// if it is not the start of an element. Additionally sets the content
-    /// type of the element to content.
+    /// type of the element to content. The returned name is only valid
+    /// until another element is started.
     /// </summary>
-    xml::qname expect_start_element(xml::content content);
+    const xml::qname &expect_start_element(xml::content content);
 
     /// <summary>
     /// Handles the next event in the XML parser and throws an exception
@@ -314,6 +487,11 @@ private:
     /// </summary>
     void expect_end_element(const xml::qname &name);
 
+    /// <summary>
+    /// Pushes name onto the stack of open elements.
+    /// </summary>
+    void push_element(const xml::qname &name);
+
     /// <summary>
     /// Returns true if the top of the parsing stack is called name and
     /// the end of that element hasn't been reached in the XML document.
@@ -339,10 +517,28 @@ private:
     /// </summary>
     class manifest &manifest();
 
+    /// <summary>
+    /// The mapped file passed to read, kept for worksheets that are read later.
+    /// </summary>
+    std::unique_ptr<mapped_file> source_file_;
+
+    /// <summary>
+    /// A copy of the data of the stream passed to read when worksheets are
+    /// read later, since the stream may not outlive load.
+    /// </summary>
+    std::string source_data_;
+
 	/// <summary>
-	/// The ZIP file containing the files that make up the OOXML package.
+	/// The ZIP file containing the files that make up the OOXML package. It is
+	/// shared with the consumers that read deferred worksheets.
 	/// </summary>
-	std::unique_ptr<izstream> archive_;
+	std::shared_ptr<izstream> archive_;
+
+    /// <summary>
+    /// The worksheets that load_options::lazy_worksheets left unread. Their
+    /// relationship IDs are looked up by title when they're read.
+    /// </summary>
+    std::unordered_set<worksheet_impl *> deferred_worksheets_;
 
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
@@ -356,9 +552,10 @@ private:
 	std::unordered_map<std::string, std::size_t> sheet_title_index_map_;
 
 	/// <summary>
-	/// A reference to the workbook which is being read.
+	/// The workbook which is being read. Worksheets read after load has returned
+	/// update this to the workbook that currently owns them.
 	/// </summary>
-	workbook &target_;
+	workbook *target_;
 
 	/// <summary>
 	/// This pointer is generally set by instantiating an xml::parser in a function
@@ -367,9 +564,66 @@ private:
 	/// </summary>
 	xml::parser *parser_;
     
+    /// <summary>
+    /// The names of the elements currently open, innermost last. Only the first
+    /// depth_ entries are open. The rest are kept so that their strings can be
+    /// reused by the next elements started instead of being reallocated.
+    /// </summary>
     std::vector<xml::qname> stack_;
 
+    /// <summary>
+    /// The number of elements currently open.
+    /// </summary>
+    std::size_t depth_ = 0;
+
     bool preserve_space_ = false;
+
+    /// <summary>
+    /// If true, worksheet parts are not read by read_office_document. They
+    /// are instead read incrementally with begin_worksheet and read_row.
+    /// </summary>
+    bool streaming_ = false;
+
+    /// <summary>
+    /// The decompressing streambuf of the worksheet currently being streamed.
+    /// </summary>
+    std::unique_ptr<std::streambuf> streaming_part_streambuf_;
+
+    /// <summary>
+    /// The stream wrapping streaming_part_streambuf_.
+    /// </summary>
+    std::unique_ptr<std::istream> streaming_part_stream_;
+
+    /// <summary>
+    /// The parser of the worksheet currently being streamed. It stays alive
+    /// between calls to read_row so that parser_ can keep pointing to it.
+    /// </summary>
+    std::unique_ptr<xml::parser> streaming_parser_;
+
+    /// <summary>
+    /// The index of the last row returned by read_row, used when a row
+    /// has no "r" attribute.
+    /// </summary>
+    row_t streaming_row_ = 0;
+
+    /// <summary>
+    /// Options passed to read.
+    /// </summary>
+    load_options options_;
+
+    /// <summary>
+    /// The target stylesheet's formats indexed by ID, collected before
+    /// worksheets are read so that cells can be formatted without searching
+    /// the stylesheet's list.
+    /// </summary>
+    std::vector<format_impl *> formats_;
+
+    /// <summary>
+    /// The merged ranges of the worksheet being read. Merging cells can change
+    /// the workbook's shared strings, so it's left to finish_worksheet, which
+    /// runs on the calling thread.
+    /// </summary>
+    std::vector<range_reference> merged_cells_;
 };
 
 } // namespace detail
@@ -21,6 +21,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cmath>
 #include <numeric> // for std::accumulate
 #include <string>
@@ -36,6 +37,8 @@
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/streamed_row.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
@@ -45,14 +48,6 @@ using namespace std::string_literals;
 
 namespace {
 
-/// <summary>
-/// Returns true if d is exactly equal to an integer.
-/// </summary>
-bool is_integral(long double d)
-{
-    return std::fabs(d - static_cast<long double>(static_cast<long long int>(d))) == 0.L;
-}
-
 std::vector<std::pair<std::string, std::string>> core_property_namespace(xlnt::core_property type)
 {
     using xlnt::core_property;
@@ -93,11 +88,257 @@ xlsx_producer::xlsx_producer(const workbook &target)
 
 void xlsx_producer::write(std::ostream &destination)
 {
-    ozstream archive(destination);
+    write(destination, save_options());
+}
+
+void xlsx_producer::write(std::ostream &destination, const save_options &options)
+{
+    options_ = options;
+    ozstream archive(destination, options.compression_threads);
     archive_ = &archive;
     populate_archive();
 }
 
+void xlsx_producer::open(std::ostream &destination)
+{
+    streaming_archive_.reset(new ozstream(destination));
+    archive_ = streaming_archive_.get();
+}
+
+void xlsx_producer::begin_worksheet(const std::string &title)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
+    end_worksheet();
+
+    const auto rel_id_iter = source_.d_->sheet_title_rel_id_map_.find(title);
+
+    if (rel_id_iter == source_.d_->sheet_title_rel_id_map_.end())
+    {
+        throw key_not_found();
+    }
+
+    const auto workbook_rel = source_.manifest().relationship(path("/"), relationship_type::office_document);
+    const auto sheet_rel = source_.manifest().relationship(workbook_rel.target().path(), rel_id_iter->second);
+    const auto worksheet_part = sheet_rel.source().path().parent().append(sheet_rel.target().path());
+
+    if (std::find(streamed_worksheet_parts_.begin(), streamed_worksheet_parts_.end(), worksheet_part)
+        != streamed_worksheet_parts_.end())
+    {
+        throw xlnt::exception("worksheet has already been written: " + title);
+    }
+
+    begin_part(worksheet_part, relationship_type::worksheet);
+    streamed_worksheet_parts_.push_back(worksheet_part);
+    streaming_worksheet_ = true;
+    streaming_row_ = 0;
+
+    write_start_element(xmlns, "worksheet");
+    write_namespace(xmlns, "");
+    write_namespace(xmlns_r, "r");
+
+    write_start_element(xmlns, "sheetData");
+    write_characters("");
+    streamed_sheet_data_.reset(new sheet_data_writer(current_part_stream_));
+}
+
+void xlsx_producer::write_row(const streamed_row &row, const std::vector<std::size_t> &shared_string_indices)
+{
+    if (!streaming_worksheet_)
+    {
+        throw xlnt::exception("no worksheet has been started");
+    }
+
+    const auto row_index = row.index == 0 ? streaming_row_ + 1 : row.index;
+
+    if (row_index <= streaming_row_)
+    {
+        throw invalid_parameter();
+    }
+
+    // checked before anything is written so that a rejected row leaves no markup behind
+    column_t::index_t previous_column = 0;
+    std::size_t format_count = 0;
+
+    for (const auto &cell : row.cells)
+    {
+        // Excel rejects rows whose cells aren't in strictly ascending column order
+        if (cell.reference.column().index <= previous_column)
+        {
+            throw invalid_parameter();
+        }
+
+        previous_column = cell.reference.column().index;
+
+        if (cell.format_id.is_set())
+        {
+            format_count = std::max(format_count, cell.format_id.get() + 1);
+        }
+    }
+
+    if (format_count > streamed_formats_)
+    {
+        if (!source_.d_->stylesheet_.is_set() || format_count > source_.d_->stylesheet_.get().format_impls.size())
+        {
+            throw invalid_parameter();
+        }
+
+        // formats up to the highest one used are referenced so that compacting
+        // styles before close can't remove or renumber any that rows refer to
+        auto &formats = source_.d_->stylesheet_.get().format_impls;
+
+        for (; streamed_formats_ < format_count; ++streamed_formats_)
+        {
+            ++formats[streamed_formats_].references;
+        }
+    }
+
+    streaming_row_ = row_index;
+
+    auto &sheet_data = *streamed_sheet_data_;
+
+    sheet_data.write_fragment("<row r=\"");
+    sheet_data.write_unsigned(row_index);
+    sheet_data.write_fragment("\">");
+
+    auto next_shared_string = shared_string_indices.begin();
+
+    for (const auto &cell : row.cells)
+    {
+        sheet_data.write_fragment("<c r=\"");
+        sheet_data.write_reference(cell.reference.column().index, static_cast<row_t>(row_index));
+        sheet_data.write_fragment("\"");
+
+        if (cell.format_id.is_set())
+        {
+            sheet_data.write_fragment(" s=\"");
+            sheet_data.write_unsigned(cell.format_id.get());
+            sheet_data.write_fragment("\"");
+        }
+
+        switch (cell.type)
+        {
+        case cell::type::boolean:
+            sheet_data.write_fragment(" t=\"b\">");
+            break;
+
+        case cell::type::error:
+            sheet_data.write_fragment(" t=\"e\">");
+            break;
+
+        case cell::type::inline_string:
+            sheet_data.write_fragment(" t=\"inlineStr\">");
+            break;
+
+        case cell::type::shared_string:
+            sheet_data.write_fragment(" t=\"s\">");
+            break;
+
+        case cell::type::formula_string:
+            sheet_data.write_fragment(" t=\"str\">");
+            break;
+
+        default:
+            sheet_data.write_fragment(">");
+            break;
+        }
+
+        if (cell.formula.is_set())
+        {
+            sheet_data.write_fragment("<f>");
+            sheet_data.write_text(cell.formula.get());
+            sheet_data.write_fragment("</f>");
+        }
+
+        switch (cell.type)
+        {
+        case cell::type::boolean:
+            if (cell.number != 0)
+            {
+                sheet_data.write_fragment("<v>1</v>");
+            }
+            else
+            {
+                sheet_data.write_fragment("<v>0</v>");
+            }
+            break;
+
+        case cell::type::error:
+        case cell::type::formula_string:
+            sheet_data.write_fragment("<v>");
+            sheet_data.write_text(cell.text);
+            sheet_data.write_fragment("</v>");
+            break;
+
+        case cell::type::inline_string:
+            sheet_data.write_fragment("<is><t>");
+            sheet_data.write_text(cell.text);
+            sheet_data.write_fragment("</t></is>");
+            break;
+
+        case cell::type::number:
+            sheet_data.write_fragment("<v>");
+            sheet_data.write_number(cell.number);
+            sheet_data.write_fragment("</v>");
+            break;
+
+        case cell::type::shared_string:
+            if (next_shared_string == shared_string_indices.end())
+            {
+                throw xlnt::exception("missing shared string index");
+            }
+
+            sheet_data.write_fragment("<v>");
+            sheet_data.write_unsigned(*next_shared_string++);
+            sheet_data.write_fragment("</v>");
+            ++streamed_shared_string_count_;
+            break;
+
+        default:
+            break;
+        }
+
+        sheet_data.write_fragment("</c>");
+    }
+
+    sheet_data.write_fragment("</row>");
+}
+
+void xlsx_producer::end_worksheet()
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+
+    if (!streaming_worksheet_)
+    {
+        return;
+    }
+
+    streamed_sheet_data_->flush();
+    streamed_sheet_data_.reset();
+
+    write_end_element(xmlns, "sheetData");
+    write_end_element(xmlns, "worksheet");
+    end_part();
+
+    streaming_worksheet_ = false;
+}
+
+void xlsx_producer::close()
+{
+    if (!streaming_archive_)
+    {
+        return;
+    }
+
+    end_worksheet();
+    populate_archive();
+
+    // the central directory is written when the archive is destroyed
+    streaming_archive_.reset();
+    archive_ = nullptr;
+}
+
 // Part Writing Methods
 
 void xlsx_producer::populate_archive()
@@ -112,11 +353,11 @@ void xlsx_producer::populate_archive()
         // thumbnail is binary content so we don't want to open an xml serializer stream
         if (rel.type() == relationship_type::thumbnail)
         {
-            write_image(rel.target().path());
+            write_image(rel.target().path(), rel.type());
             continue;
         }
 
-        begin_part(rel.target().path());
+        begin_part(rel.target().path(), rel.type());
 
         if (rel.type() == relationship_type::core_properties)
         {
@@ -157,11 +398,26 @@ void xlsx_producer::end_part()
 void xlsx_producer::begin_part(const path &part)
 {
     end_part();
-    current_part_streambuf_ = archive_->open(part);
+    current_part_streambuf_ = archive_->open(part, options_.compression_level, options_.strategy);
     current_part_stream_.rdbuf(current_part_streambuf_.get());
     current_part_serializer_.reset(new xml::serializer(current_part_stream_, part.string()));
 }
 
+void xlsx_producer::begin_part(const path &part, relationship_type type)
+{
+    end_part();
+    current_part_streambuf_ = archive_->open(part, compression_level(type), options_.strategy);
+    current_part_stream_.rdbuf(current_part_streambuf_.get());
+    current_part_serializer_.reset(new xml::serializer(current_part_stream_, part.string()));
+}
+
+int xlsx_producer::compression_level(relationship_type type) const
+{
+    const auto level_iter = options_.part_compression_levels.find(type);
+
+    return level_iter == options_.part_compression_levels.end() ? options_.compression_level : level_iter->second;
+}
+
 // Package Parts
 
 void xlsx_producer::write_content_types()
@@ -635,7 +891,15 @@ void xlsx_producer::write_workbook(const relationship &rel)
         if (child_rel.type() == relationship_type::calculation_chain) continue;
 
         path archive_path(child_rel.source().path().parent().append(child_rel.target().path()));
-        begin_part(archive_path);
+
+        // worksheets written by begin_worksheet/write_row are already in the archive
+        if (child_rel.type() == relationship_type::worksheet
+            && std::find(streamed_worksheet_parts_.begin(), streamed_worksheet_parts_.end(), archive_path)
+                != streamed_worksheet_parts_.end())
+        {
+            continue;
+        }
+        begin_part(archive_path, child_rel.type());
 
         switch (child_rel.type())
         {
@@ -781,30 +1045,21 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_namespace(xmlns, "");
 
     // todo: is there a more elegant way to get this number?
-    std::size_t string_count = 0;
+    std::size_t string_count = streamed_shared_string_count_;
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wrange-loop-analysis"
     for (const auto ws : source_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
+        for (const auto &block : ws.d_->cells_.rows())
         {
-            while (current_cell.column() <= dimension.bottom_right().column())
+            for (const auto &slot : block.cells)
             {
-                if (ws.has_cell(current_cell)
-                    && ws.cell(current_cell).data_type() == cell::type::shared_string)
+                if (xlnt::cell(slot.impl).data_type() == cell::type::shared_string)
                 {
                     ++string_count;
                 }
-
-                current_cell.column_index(current_cell.column_index() + 1);
             }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
         }
     }
 #pragma clang diagnostic pop
@@ -1976,7 +2231,7 @@ void xlsx_producer::write_theme(const relationship &theme_rel)
             if (rel.type() == relationship_type::image)
             {
                 const auto image_path = source_.manifest().canonicalize({workbook_rel, theme_rel, rel});
-                write_image(image_path);
+                write_image(image_path, rel.type());
             }
         }
     }
@@ -2167,64 +2422,81 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     write_start_element(xmlns, "sheetData");
 
-    for (auto row : ws.rows())
+    // cells are written by a sheet_data_writer rather than through the serializer,
+    // so the start tag is closed first by writing empty content
+    write_characters("");
+    sheet_data_writer sheet_data(current_part_stream_);
+
+    // only the cells that exist are visited, in row and then column order,
+    // rather than every position within the worksheet's dimension
+    for (const auto &block : ws.d_->cells_.rows())
     {
-        auto min = static_cast<xlnt::row_t>(row.length());
-        xlnt::row_t max = 0;
-        bool any_non_null = false;
+        auto min = column_t::index_t(0);
+        auto max = column_t::index_t(0);
 
-        for (auto cell : row)
+        for (const auto &slot : block.cells)
         {
-            min = std::min(min, cell.column().index);
-            max = std::max(max, cell.column().index);
-
-            if (!cell.garbage_collectible())
+            if (xlnt::cell(slot.impl).garbage_collectible())
             {
-                any_non_null = true;
+                continue;
             }
+
+            min = min == 0 ? slot.column : min;
+            max = slot.column;
         }
 
-        if (!any_non_null)
+        if (max == 0)
         {
             continue;
         }
 
-        write_start_element(xmlns, "row");
-
-        write_attribute("r", row.front().row());
-        write_attribute("spans", std::to_string(min) + ":" + std::to_string(max));
+        sheet_data.write_fragment("<row r=\"");
+        sheet_data.write_unsigned(block.row);
+        sheet_data.write_fragment("\" spans=\"");
+        sheet_data.write_unsigned(min);
+        sheet_data.write_fragment(":");
+        sheet_data.write_unsigned(max);
+        sheet_data.write_fragment("\"");
 
-        if (ws.has_row_properties(row.front().row()))
+        if (ws.has_row_properties(block.row))
         {
-            const auto &props = ws.row_properties(row.front().row());
+            const auto &props = ws.row_properties(block.row);
 
             if (props.custom_height)
             {
-                write_attribute("customHeight", write_bool(true));
+                sheet_data.write_fragment(" customHeight=\"1\"");
             }
 
             if (props.height.is_set())
             {
                 auto height = props.height.get();
 
+                sheet_data.write_fragment(" ht=\"");
+
                 if (std::fabs(height - std::floor(height)) == 0.0)
                 {
-                    write_attribute("ht", std::to_string(static_cast<int>(height)) + ".0");
+                    sheet_data.write_unsigned(static_cast<std::uint64_t>(height));
+                    sheet_data.write_fragment(".0");
                 }
                 else
                 {
-                    write_attribute("ht", height);
+                    sheet_data.write_number(height);
                 }
+
+                sheet_data.write_fragment("\"");
             }
 
             if (props.hidden)
             {
-                write_attribute("hidden", write_bool(true));
+                sheet_data.write_fragment(" hidden=\"1\"");
             }
         }
 
-        for (auto cell : row) // CT_Cell
+        sheet_data.write_fragment(">");
+
+        for (const auto &slot : block.cells) // CT_Cell
         {
+            auto cell = xlnt::cell(slot.impl);
             if (cell.garbage_collectible()) continue;
 
             // record data about the cell needed later
@@ -2239,119 +2511,115 @@ void xlsx_producer::write_worksheet(const relationship &rel)
                 hyperlink_references[cell.reference().to_string()] = reverse_hyperlink_references[cell.hyperlink()];
             }
 
-            write_start_element(xmlns, "c");
-
             // begin cell attributes
 
-            write_attribute("r", cell.reference().to_string());
+            sheet_data.write_fragment("<c r=\"");
+            sheet_data.write_reference(slot.column, block.row);
+            sheet_data.write_fragment("\"");
 
             if (cell.has_format())
             {
-                write_attribute("s", cell.format().d_->id);
+                sheet_data.write_fragment(" s=\"");
+                sheet_data.write_unsigned(cell.format().d_->id);
+                sheet_data.write_fragment("\"");
             }
 
             switch (cell.data_type())
             {
             case cell::type::boolean:
-                write_attribute("t", "b");
+                sheet_data.write_fragment(" t=\"b\">");
                 break;
 
             case cell::type::date:
-                write_attribute("t", "d");
+                sheet_data.write_fragment(" t=\"d\">");
                 break;
 
             case cell::type::error:
-                write_attribute("t", "e");
+                sheet_data.write_fragment(" t=\"e\">");
                 break;
 
             case cell::type::inline_string:
-                write_attribute("t", "inlineStr");
+                sheet_data.write_fragment(" t=\"inlineStr\">");
                 break;
 
             case cell::type::number:
-                write_attribute("t", "n");
+                sheet_data.write_fragment(" t=\"n\">");
                 break;
 
             case cell::type::shared_string:
-                write_attribute("t", "s");
+                sheet_data.write_fragment(" t=\"s\">");
                 break;
 
             case cell::type::formula_string:
-                write_attribute("t", "str");
+                sheet_data.write_fragment(" t=\"str\">");
                 break;
 
             default:
+                sheet_data.write_fragment(">");
                 break;
             }
 
-            //write_attribute("cm", "");
-            //write_attribute("vm", "");
-            //write_attribute("ph", "");
-
             // begin child elements
 
             if (cell.has_formula())
             {
-                write_element(xmlns, "f", cell.formula());
+                sheet_data.write_fragment("<f>");
+                sheet_data.write_text(cell.formula());
+                sheet_data.write_fragment("</f>");
             }
 
             switch (cell.data_type())
             {
             case cell::type::boolean:
-                write_element(xmlns, "v", write_bool(cell.value<bool>()));
+                if (cell.value<bool>())
+                {
+                    sheet_data.write_fragment("<v>1</v>");
+                }
+                else
+                {
+                    sheet_data.write_fragment("<v>0</v>");
+                }
                 break;
 
             case cell::type::date:
-                write_element(xmlns, "v", cell.value<std::string>());
-                break;
-
             case cell::type::error:
-                write_element(xmlns, "v", cell.value<std::string>());
+            case cell::type::formula_string:
+                sheet_data.write_fragment("<v>");
+                sheet_data.write_text(cell.value<std::string>());
+                sheet_data.write_fragment("</v>");
                 break;
 
             case cell::type::inline_string:
-                write_start_element(xmlns, "is");
                 // TODO: make a write_rich_text method and use that here
-                write_element(xmlns, "t", cell.value<std::string>());
-                write_end_element(xmlns, "is");
+                sheet_data.write_fragment("<is><t>");
+                sheet_data.write_text(cell.value<std::string>());
+                sheet_data.write_fragment("</t></is>");
                 break;
 
             case cell::type::number:
-                write_start_element(xmlns, "v");
-
-                if (is_integral(cell.value<long double>()))
-                {
-                    write_characters(static_cast<std::ptrdiff_t>(cell.value<long double>()));
-                }
-                else
-                {
-                    std::stringstream ss;
-                    ss.precision(20);
-                    ss << cell.value<long double>();
-                    write_characters(ss.str());
-                }
-
-                write_end_element(xmlns, "v");
+                sheet_data.write_fragment("<v>");
+                sheet_data.write_number(cell.d_->value_numeric_);
+                sheet_data.write_fragment("</v>");
                 break;
 
             case cell::type::shared_string:
-                write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                break;
-
-            case cell::type::formula_string:
-                write_element(xmlns, "v", cell.value<std::string>());
+                sheet_data.write_fragment("<v>");
+                sheet_data.write_unsigned(static_cast<std::size_t>(cell.d_->value_numeric_));
+                sheet_data.write_fragment("</v>");
                 break;
 
             default:
                 break;
             }
 
-            write_end_element(xmlns, "c");
+            sheet_data.write_fragment("</c>");
         }
 
-        write_end_element(xmlns, "row");
+        sheet_data.write_fragment("</row>");
     }
 
+    sheet_data.flush();
+
     write_end_element(xmlns, "sheetData");
 
     if (ws.has_auto_filter())
@@ -2669,7 +2937,7 @@ void xlsx_producer::write_worksheet(const relationship &rel)
             archive_path = std::accumulate(split_part_path.begin(), split_part_path.end(), path(""),
                 [](const path &a, const std::string &b) { return a.append(b); });
 
-            begin_part(archive_path);
+            begin_part(archive_path, child_rel.type());
 
             if (child_rel.type() == relationship_type::comments)
             {
@@ -2948,12 +3216,12 @@ void xlsx_producer::write_unknown_relationships()
 {
 }
 
-void xlsx_producer::write_image(const path &image_path)
+void xlsx_producer::write_image(const path &image_path, relationship_type type)
 {
     end_part();
 
     vector_istreambuf buffer(source_.d_->images_.at(image_path.string()));
-    auto image_streambuf = archive_->open(image_path);
+    auto image_streambuf = archive_->open(image_path, compression_level(type), options_.strategy);
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
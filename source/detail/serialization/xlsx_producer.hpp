@@ -30,6 +30,10 @@
 
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <detail/serialization/zstream.hpp>
+#include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/save_options.hpp>
 
 namespace xml {
 class serializer;
@@ -48,6 +52,8 @@ class variant;
 class workbook;
 class worksheet;
 
+struct streamed_row;
+
 namespace detail {
 
 class ozstream;
@@ -64,6 +70,45 @@ public:
 
     void write(std::ostream &destination, const std::string &password);
 
+    /// <summary>
+    /// Writes the workbook to destination as write(destination) does, using the given options.
+    /// </summary>
+    void write(std::ostream &destination, const save_options &options);
+
+    // Streaming
+
+    /// <summary>
+    /// Starts writing an archive to destination. Worksheets can then be
+    /// written one row at a time with begin_worksheet and write_row. All
+    /// other parts are written when close is called.
+    /// </summary>
+    void open(std::ostream &destination);
+
+    /// <summary>
+    /// Opens the part of the worksheet with the given title and writes
+    /// everything up to and including the start of its sheetData element.
+    /// </summary>
+    void begin_worksheet(const std::string &title);
+
+    /// <summary>
+    /// Writes row to the current worksheet. shared_string_indices holds the
+    /// shared string table index of each shared_string cell in row, in order.
+    /// Throws invalid_parameter, writing nothing, if the columns of the cells
+    /// aren't strictly ascending or a format_id isn't in the stylesheet.
+    /// </summary>
+    void write_row(const streamed_row &row, const std::vector<std::size_t> &shared_string_indices);
+
+    /// <summary>
+    /// Closes the sheetData and worksheet elements and the worksheet part.
+    /// </summary>
+    void end_worksheet();
+
+    /// <summary>
+    /// Ends the current worksheet, writes all remaining parts of the
+    /// workbook and finishes the archive.
+    /// </summary>
+    void close();
+
 private:
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
@@ -72,8 +117,21 @@ private:
 	void populate_archive();
 
     void begin_part(const path &part);
+
+    /// <summary>
+    /// Starts writing the part with the given path which is the target of a
+    /// relationship of the given type, compressing it at the level set for
+    /// that type in the save options.
+    /// </summary>
+    void begin_part(const path &part, relationship_type type);
+
     void end_part();
 
+    /// <summary>
+    /// Returns the compression level for parts with the given relationship type.
+    /// </summary>
+    int compression_level(relationship_type type) const;
+
 	// Package Parts
 
 	void write_content_types();
@@ -81,7 +139,7 @@ private:
 	void write_core_properties(const relationship &rel);
     void write_extended_properties(const relationship &rel);
     void write_custom_properties(const relationship &rel);
-    void write_image(const path &image_path);
+    void write_image(const path &image_path, relationship_type type);
 
 	// SpreadsheetML-Specific Package Parts
 
@@ -180,9 +238,53 @@ private:
 	const workbook &source_;
     
 	ozstream *archive_;
+
+    /// <summary>
+    /// The options passed to write, which control how parts are compressed.
+    /// </summary>
+    save_options options_;
     std::unique_ptr<xml::serializer> current_part_serializer_;
     std::unique_ptr<std::streambuf> current_part_streambuf_;
     std::ostream current_part_stream_;
+
+    /// <summary>
+    /// The archive created by open and finished by close.
+    /// </summary>
+    std::unique_ptr<ozstream> streaming_archive_;
+
+    /// <summary>
+    /// True between begin_worksheet and end_worksheet.
+    /// </summary>
+    bool streaming_worksheet_ = false;
+
+    /// <summary>
+    /// The index of the last row written by write_row.
+    /// </summary>
+    std::size_t streaming_row_ = 0;
+
+    /// <summary>
+    /// Writes the rows passed to write_row into the sheetData element of the
+    /// current worksheet. It is flushed by end_worksheet.
+    /// </summary>
+    std::unique_ptr<sheet_data_writer> streamed_sheet_data_;
+
+    /// <summary>
+    /// The number of formats, from the first, that write_row has counted a
+    /// reference to on behalf of the rows it has written.
+    /// </summary>
+    std::size_t streamed_formats_ = 0;
+
+    /// <summary>
+    /// Worksheet parts which have already been written by begin_worksheet
+    /// and should be skipped by write_workbook.
+    /// </summary>
+    std::vector<path> streamed_worksheet_parts_;
+
+    /// <summary>
+    /// The number of shared string cells written by write_row. These cells
+    /// aren't in the workbook so they need to be counted separately.
+    /// </summary>
+    std::size_t streamed_shared_string_count_ = 0;
 };
 
 } // namespace detail
@@ -37,12 +37,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <iterator> // for std::back_inserter
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 #include <xlnt/utils/exceptions.hpp>
 #include <detail/serialization/miniz.hpp>
@@ -66,6 +70,63 @@ void write_int(std::ostream &stream, T value)
     stream.write(reinterpret_cast<char *>(&value), sizeof(T));
 }
 
+// Fixed size fields set to this value are stored in a ZIP64 extended information extra field
+const std::uint32_t zip64_marker = 0xffffffff;
+const std::uint16_t zip64_extra_id = 0x0001;
+const std::uint16_t zip64_version = 45;
+
+template <class T>
+T read_extra_int(const std::vector<std::uint8_t> &extra, std::size_t offset)
+{
+    T value;
+    std::copy(extra.begin() + static_cast<std::ptrdiff_t>(offset),
+        extra.begin() + static_cast<std::ptrdiff_t>(offset + sizeof(T)),
+        reinterpret_cast<std::uint8_t *>(&value));
+
+    return value;
+}
+
+// Replaces any sizes or offset which overflowed their fixed size fields
+// with the 64-bit values stored in the ZIP64 extra field, if any.
+void read_zip64_extra(xlnt::detail::zheader &header)
+{
+    std::size_t offset = 0;
+
+    while (offset + 4 <= header.extra.size())
+    {
+        const auto id = read_extra_int<std::uint16_t>(header.extra, offset);
+        const auto size = read_extra_int<std::uint16_t>(header.extra, offset + 2);
+        offset += 4;
+
+        if (offset + size > header.extra.size())
+        {
+            throw xlnt::exception("invalid ZIP extra field");
+        }
+
+        if (id == zip64_extra_id)
+        {
+            const auto end = offset + size;
+
+            for (auto field : {&header.uncompressed_size, &header.compressed_size, &header.header_offset})
+            {
+                if (*field != zip64_marker) continue;
+
+                if (offset + 8 > end)
+                {
+                    throw xlnt::exception("invalid ZIP64 extra field");
+                }
+
+                *field = read_extra_int<std::uint64_t>(header.extra, offset);
+                offset += 8;
+            }
+
+            return;
+        }
+
+        offset += size;
+    }
+}
+
 xlnt::detail::zheader read_header(std::istream &istream, const bool global)
 {
     xlnt::detail::zheader header;
@@ -123,31 +184,51 @@ xlnt::detail::zheader read_header(std::istream &istream, const bool global)
         istream.read(&header.comment[0], comment_length);
     }
 
+    read_zip64_extra(header);
+
     return header;
 }
 
 void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, const bool global)
 {
+    // Local headers are written before the sizes are known and rewritten in place
+    // afterwards, so they always reserve room for 64-bit sizes. Central headers
+    // only include the fields which don't fit in 32 bits.
+    const auto large_sizes = header.compressed_size >= zip64_marker || header.uncompressed_size >= zip64_marker;
+    const auto large_offset = global && header.header_offset >= zip64_marker;
+    const auto write_uncompressed_size = !global || header.uncompressed_size >= zip64_marker;
+    const auto write_compressed_size = !global || header.compressed_size >= zip64_marker;
+
+    std::vector<std::uint64_t> zip64_fields;
+    if (write_uncompressed_size) zip64_fields.push_back(header.uncompressed_size);
+    if (write_compressed_size) zip64_fields.push_back(header.compressed_size);
+    if (large_offset) zip64_fields.push_back(header.header_offset);
+
+    // any header carrying the ZIP64 extra field needs version 4.5 to extract,
+    // even a local header whose sizes turned out to fit in 32 bits
+    const auto zip64 = !zip64_fields.empty();
+    const auto version = zip64 ? std::max(header.version, zip64_version) : header.version;
+
     if (global)
     {
         write_int(ostream, static_cast<std::uint32_t>(0x02014b50)); // header sig
-        write_int(ostream, static_cast<std::uint16_t>(20)); // version made by
+        write_int(ostream, static_cast<std::uint16_t>(zip64 ? zip64_version : 20)); // version made by
     }
     else
     {
         write_int(ostream, static_cast<std::uint32_t>(0x04034b50));
     }
 
-    write_int(ostream, header.version);
+    write_int(ostream, version);
     write_int(ostream, header.flags);
     write_int(ostream, header.compression_type);
     write_int(ostream, header.stamp_date);
     write_int(ostream, header.stamp_time);
     write_int(ostream, header.crc);
-    write_int(ostream, header.compressed_size);
-    write_int(ostream, header.uncompressed_size);
+    write_int(ostream, large_sizes ? zip64_marker : static_cast<std::uint32_t>(header.compressed_size));
+    write_int(ostream, large_sizes ? zip64_marker : static_cast<std::uint32_t>(header.uncompressed_size));
     write_int(ostream, static_cast<std::uint16_t>(header.filename.length()));
-    write_int(ostream, static_cast<std::uint16_t>(0)); // extra lengthx
+    write_int(ostream, static_cast<std::uint16_t>(zip64_fields.empty() ? 0 : 4 + 8 * zip64_fields.size())); // extra length
 
     if (global)
     {
@@ -155,13 +236,24 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
         write_int(ostream, static_cast<std::uint16_t>(0)); // disk# start
         write_int(ostream, static_cast<std::uint16_t>(0)); // internal file
         write_int(ostream, static_cast<std::uint32_t>(0)); // ext final
-        write_int(ostream, static_cast<std::uint32_t>(header.header_offset)); // rel offset
+        write_int(ostream, large_offset ? zip64_marker : static_cast<std::uint32_t>(header.header_offset)); // rel offset
     }
 
     for (auto c : header.filename)
     {
         write_int(ostream, c);
     }
+
+    if (!zip64_fields.empty())
+    {
+        write_int(ostream, zip64_extra_id);
+        write_int(ostream, static_cast<std::uint16_t>(8 * zip64_fields.size()));
+
+        for (auto field : zip64_fields)
+        {
+            write_int(ostream, field);
+        }
+    }
 }
 
 } // namespace
@@ -179,8 +271,8 @@ class zip_streambuf_decompress : public std::streambuf
     std::array<char, buffer_size> in;
     std::array<char, buffer_size> out;
     zheader header;
-    std::size_t total_read;
-    std::size_t total_uncompressed;
+    std::uint64_t total_read;
+    std::uint64_t total_uncompressed;
     bool valid;
     bool compressed_data;
 
@@ -260,7 +352,7 @@ public:
                 {
                     // buffer empty, read some more from file
                     istream.read(in.data(),
-                        static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
+                        static_cast<std::streamsize>(std::min<std::uint64_t>(buffer_size, header.compressed_size - total_read)));
                     strm.avail_in = static_cast<unsigned int>(istream.gcount());
                     total_read += strm.avail_in;
                     strm.next_in = reinterpret_cast<Bytef *>(in.data());
@@ -283,9 +375,9 @@ public:
 
         // uncompressed, so just read
         istream.read(out.data() + 4,
-            static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
+            static_cast<std::streamsize>(std::min<std::uint64_t>(buffer_size - 4, header.uncompressed_size - total_read)));
         auto count = istream.gcount();
-        total_read += static_cast<std::size_t>(count);
+        total_read += static_cast<std::uint64_t>(count);
         return static_cast<int>(count);
     }
 
@@ -311,6 +403,306 @@ int zip_streambuf_decompress::overflow(int)
     throw xlnt::exception("writing to read-only buffer");
 }
 
+/// <summary>
+/// Holds an in-memory copy of a file's local header and compressed data.
+/// This is a separate base class so that it is constructed before the
+/// zip_streambuf_decompress base which reads from it.
+/// </summary>
+struct zip_detached_source
+{
+    zip_detached_source(std::vector<std::uint8_t> &&bytes)
+        : data(std::move(bytes)),
+          buffer(data),
+          stream(&buffer)
+    {
+    }
+
+    std::vector<std::uint8_t> data;
+    xlnt::detail::vector_istreambuf buffer;
+    std::istream stream;
+};
+
+/// <summary>
+/// Decompresses a file from an in-memory copy rather than from the archive's stream.
+/// </summary>
+class zip_streambuf_decompress_detached : private zip_detached_source, public zip_streambuf_decompress
+{
+public:
+    zip_streambuf_decompress_detached(std::vector<std::uint8_t> &&bytes, zheader central_header)
+        : zip_detached_source(std::move(bytes)),
+          zip_streambuf_decompress(zip_detached_source::stream, central_header)
+    {
+    }
+};
+
+/// <summary>
+/// Allows memory that is never written, such as a mapped file, to be read through a std::istream.
+/// </summary>
+class memory_istreambuf : public std::streambuf
+{
+public:
+    memory_istreambuf(const std::uint8_t *data, std::size_t size)
+    {
+        // the get area is only ever read from
+        auto begin = reinterpret_cast<char *>(const_cast<std::uint8_t *>(data));
+        setg(begin, begin, begin + size);
+    }
+
+private:
+    virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode mode)
+    {
+        const auto invalid = std::streampos(std::streamoff(-1));
+
+        if ((mode & std::ios_base::in) == 0) return invalid;
+
+        auto position = off;
+
+        if (way == std::ios_base::cur)
+        {
+            position += gptr() - eback();
+        }
+        else if (way == std::ios_base::end)
+        {
+            position += egptr() - eback();
+        }
+
+        if (position < 0 || position > egptr() - eback()) return invalid;
+
+        setg(eback(), eback() + position, egptr());
+
+        return std::streampos(position);
+    }
+
+    virtual std::streampos seekpos(std::streampos sp, std::ios_base::openmode mode)
+    {
+        return seekoff(std::streamoff(sp), std::ios_base::beg, mode);
+    }
+};
+
+/// <summary>
+/// The size of the output buffer used when inflating a file from memory.
+/// </summary>
+static const std::size_t memory_buffer_size = 64 * 1024;
+
+/// <summary>
+/// The number of characters kept at the start of the output buffer so that they can be put back.
+/// </summary>
+static const std::size_t memory_put_back_size = 4;
+
+/// <summary>
+/// Decompresses a file from an archive held in memory. Compressed data is passed
+/// to inflate without being copied and stored data is read in place. The archive
+/// is never modified, so any number of these can read the same archive concurrently.
+/// </summary>
+class zip_streambuf_decompress_memory : public std::streambuf
+{
+    z_stream strm;
+    std::vector<char> out;
+    const std::uint8_t *next_in;
+    std::uint64_t remaining_in;
+    bool compressed_data;
+    bool finished;
+
+public:
+    zip_streambuf_decompress_memory(const std::uint8_t *archive, std::size_t archive_size, const zheader &header)
+        : compressed_data(false), finished(false)
+    {
+        const std::size_t local_header_size = 30;
+        const auto offset = header.header_offset;
+
+        if (offset + local_header_size > archive_size)
+        {
+            throw xlnt::exception("unexpected end of ZIP file");
+        }
+
+        const auto local_header = archive + offset;
+        std::uint32_t signature;
+        std::uint16_t filename_length, extra_length;
+        std::copy(local_header, local_header + 4, reinterpret_cast<std::uint8_t *>(&signature));
+        std::copy(local_header + 26, local_header + 28, reinterpret_cast<std::uint8_t *>(&filename_length));
+        std::copy(local_header + 28, local_header + 30, reinterpret_cast<std::uint8_t *>(&extra_length));
+
+        if (signature != 0x04034b50)
+        {
+            throw xlnt::exception("missing local header signature");
+        }
+
+        const auto data_offset = offset + local_header_size + filename_length + extra_length;
+
+        if (header.compression_type == 8)
+        {
+            compressed_data = true;
+            remaining_in = header.compressed_size;
+        }
+        else if (header.compression_type == 0)
+        {
+            remaining_in = header.uncompressed_size;
+        }
+        else
+        {
+            throw xlnt::exception("unsupported compression type, should be DEFLATE or uncompressed");
+        }
+
+        if (data_offset + remaining_in > archive_size)
+        {
+            throw xlnt::exception("unexpected end of ZIP file");
+        }
+
+        next_in = archive + data_offset;
+
+        if (!compressed_data)
+        {
+            // the get area is only ever read from
+            auto begin = reinterpret_cast<char *>(const_cast<std::uint8_t *>(next_in));
+            setg(begin, begin, begin + remaining_in);
+
+            return;
+        }
+
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+        strm.avail_in = 0;
+        strm.next_in = Z_NULL;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+        if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+#pragma clang diagnostic pop
+        {
+            throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+        }
+
+        out.resize(memory_buffer_size);
+        setg(out.data(), out.data(), out.data());
+    }
+
+    virtual ~zip_streambuf_decompress_memory()
+    {
+        if (compressed_data)
+        {
+            inflateEnd(&strm);
+        }
+    }
+
+    virtual int_type underflow()
+    {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if (!compressed_data || finished) return traits_type::eof();
+
+        // keep the last few characters so that they can be put back
+        const auto put_back_count = std::min(static_cast<std::size_t>(gptr() - eback()), memory_put_back_size);
+        std::copy(gptr() - put_back_count, gptr(), out.data());
+
+        strm.next_out = reinterpret_cast<Bytef *>(out.data() + put_back_count);
+        strm.avail_out = static_cast<unsigned int>(out.size() - put_back_count);
+
+        while (strm.avail_out != 0 && !finished)
+        {
+            if (strm.avail_in == 0)
+            {
+                if (remaining_in == 0)
+                {
+                    throw xlnt::exception("unexpected end of ZIP file");
+                }
+
+                const auto chunk = std::min<std::uint64_t>(remaining_in, std::numeric_limits<unsigned int>::max());
+                strm.next_in = next_in;
+                strm.avail_in = static_cast<unsigned int>(chunk);
+                next_in += chunk;
+                remaining_in -= chunk;
+            }
+
+            const auto ret = inflate(&strm, Z_NO_FLUSH);
+
+            if (ret == Z_STREAM_END)
+            {
+                finished = true;
+            }
+            else if (ret != Z_OK)
+            {
+                throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+            }
+        }
+
+        const auto end = reinterpret_cast<char *>(strm.next_out);
+        setg(out.data(), out.data() + put_back_count, end);
+
+        if (gptr() == egptr()) return traits_type::eof();
+
+        return traits_type::to_int_type(*gptr());
+    }
+};
+
+/// <summary>
+/// The number of uncompressed bytes in each block that is compressed
+/// separately when compressing with more than one thread.
+/// </summary>
+static const std::size_t block_size = 256 * 1024;
+
+/// <summary>
+/// Returns the zlib strategy constant corresponding to strategy.
+/// </summary>
+static int zlib_strategy(compression_strategy strategy)
+{
+    switch (strategy)
+    {
+    case compression_strategy::filtered:
+        return Z_FILTERED;
+    case compression_strategy::huffman_only:
+        return Z_HUFFMAN_ONLY;
+    case compression_strategy::run_length:
+        return Z_RLE;
+    case compression_strategy::fixed:
+        return Z_FIXED;
+    case compression_strategy::default_strategy:
+        break;
+    }
+
+    return Z_DEFAULT_STRATEGY;
+}
+
+/// <summary>
+/// Compresses input into a sequence of raw deflate blocks. Unless last is
+/// true, the output ends on a byte boundary without the final block flag so
+/// that the compressed form of the next input can be appended to it.
+/// </summary>
+static std::vector<char> deflate_block(const std::vector<char> &input, bool last, int level, int strategy)
+{
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, strategy) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("libz: failed to deflateInit");
+    }
+
+    // extra room for the empty stored block written by Z_SYNC_FLUSH
+    std::vector<char> output(deflateBound(&strm, static_cast<mz_ulong>(input.size())) + 16);
+
+    strm.next_in = reinterpret_cast<const Bytef *>(input.data());
+    strm.avail_in = static_cast<unsigned int>(input.size());
+    strm.next_out = reinterpret_cast<Bytef *>(output.data());
+    strm.avail_out = static_cast<unsigned int>(output.size());
+
+    const auto ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const auto complete = last ? ret == Z_STREAM_END : (ret == Z_OK && strm.avail_in == 0 && strm.avail_out != 0);
+    output.resize(output.size() - strm.avail_out);
+    deflateEnd(&strm);
+
+    if (!complete)
+    {
+        throw xlnt::exception("libz: deflate failed");
+    }
+
+    return output;
+}
+
 class zip_streambuf_compress : public std::streambuf
 {
     std::ostream &ostream; // owned when header==0 (when not part of zip file)
@@ -320,38 +712,72 @@ class zip_streambuf_compress : public std::streambuf
     std::array<char, buffer_size> out;
 
     zheader *header;
-    std::uint32_t uncompressed_size;
+    std::uint64_t uncompressed_size;
     std::uint32_t crc;
 
     bool valid;
 
+    // Parts compressed at level 0 are stored as they are rather than being deflated.
+    bool stored;
+    int level;
+    int strategy;
+
+    // When threads is greater than 1, input is collected into blocks which are
+    // compressed separately by up to that many threads and written out in order.
+    std::size_t threads;
+    std::vector<char> block;
+    std::deque<std::future<std::vector<char>>> pending_blocks;
+
 public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream, std::size_t compression_threads = 1,
+        int compression_level = Z_DEFAULT_COMPRESSION, int compression_strategy = Z_DEFAULT_STRATEGY)
+        : ostream(stream),
+          header(central_header),
+          valid(true),
+          stored(central_header != nullptr && compression_level == 0),
+          level(compression_level),
+          strategy(compression_strategy),
+          threads(stored ? 1 : compression_threads)
     {
         strm.zalloc = Z_NULL;
         strm.zfree = Z_NULL;
         strm.opaque = Z_NULL;
 
+        if (stored)
+        {
+            header->compression_type = 0;
+        }
+        else
+        {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
-        int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            int ret = deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, strategy);
 #pragma clang diagnostic pop
 
-        if (ret != Z_OK)
-        {
-            std::cerr << "libz: failed to deflateInit" << std::endl;
-            valid = false;
-            return;
+            if (ret != Z_OK)
+            {
+                std::cerr << "libz: failed to deflateInit" << std::endl;
+                valid = false;
+                return;
+            }
         }
 
         setg(0, 0, 0);
-        setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
+
+        if (threads > 1)
+        {
+            block.resize(block_size);
+            setp(block.data(), block.data() + block.size() - 1); // leave room for overflow's character
+        }
+        else
+        {
+            setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
+        }
 
         // Write appropriate header
         if (header)
         {
-            header->header_offset = static_cast<std::uint32_t>(stream.tellp());
+            header->header_offset = static_cast<std::uint64_t>(stream.tellp());
             write_header(*header, ostream, false);
         }
 
@@ -363,29 +789,99 @@ public:
         if (valid)
         {
             process(true);
-            deflateEnd(&strm);
+            if (!stored) deflateEnd(&strm);
             if (header)
             {
                 std::ios::streampos final_position = ostream.tellp();
                 header->uncompressed_size = uncompressed_size;
                 header->crc = crc;
-                ostream.seekp(header->header_offset);
+                ostream.seekp(static_cast<std::streamoff>(header->header_offset));
                 write_header(*header, ostream, false);
                 ostream.seekp(final_position);
             }
             else
             {
                 write_int(ostream, crc);
-                write_int(ostream, uncompressed_size);
+                write_int(ostream, static_cast<std::uint32_t>(uncompressed_size));
             }
         }
         if (!header) delete &ostream;
     }
 
 protected:
+    void write_compressed(const std::vector<char> &compressed)
+    {
+        ostream.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        if (header) header->compressed_size += compressed.size();
+    }
+
+    void write_pending_blocks(std::size_t keep)
+    {
+        while (pending_blocks.size() > keep)
+        {
+            write_compressed(pending_blocks.front().get());
+            pending_blocks.pop_front();
+        }
+    }
+
+    int process_block(bool flush)
+    {
+        auto consumed_input = static_cast<std::size_t>(pptr() - pbase());
+        uncompressed_size += consumed_input;
+        crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<Bytef *>(block.data()), consumed_input));
+        block.resize(consumed_input);
+
+        try
+        {
+            if (flush)
+            {
+                // the last block is compressed on this thread while earlier ones finish
+                auto last = deflate_block(block, true, level, strategy);
+                write_pending_blocks(0);
+                write_compressed(last);
+            }
+            else
+            {
+                const auto block_level = level;
+                const auto block_strategy = strategy;
+                pending_blocks.push_back(std::async(std::launch::async,
+                    [block_level, block_strategy](const std::vector<char> &input) {
+                        return deflate_block(input, false, block_level, block_strategy);
+                    },
+                    std::move(block)));
+                write_pending_blocks(threads);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            valid = false;
+            std::cerr << "gzip: gzip error " << e.what() << std::endl;
+            return -1;
+        }
+
+        block = std::vector<char>(block_size);
+        setp(block.data(), block.data() + block.size() - 1);
+
+        return 1;
+    }
+
+    int process_stored()
+    {
+        auto consumed_input = static_cast<std::uint32_t>(pptr() - pbase());
+        ostream.write(pbase(), consumed_input);
+        header->compressed_size += consumed_input;
+        uncompressed_size += consumed_input;
+        crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<Bytef *>(pbase()), consumed_input));
+        setp(pbase(), pbase() + buffer_size - 4);
+
+        return 1;
+    }
+
     int process(bool flush)
     {
         if (!valid) return -1;
+        if (stored) return process_stored();
+        if (threads > 1) return process_block(flush);
 
         strm.next_in = reinterpret_cast<Bytef *>(pbase());
         strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
@@ -407,7 +903,7 @@ protected:
 
             auto generated_output = static_cast<int>(strm.next_out - reinterpret_cast<std::uint8_t *>(out.data()));
             ostream.write(out.data(), generated_output);
-            if (header) header->compressed_size += static_cast<std::uint32_t>(generated_output);
+            if (header) header->compressed_size += static_cast<std::uint64_t>(generated_output);
             if (ret == Z_STREAM_END) break;
         }
 
@@ -422,6 +918,8 @@ protected:
 
     virtual int sync()
     {
+        // blocks are only compressed once full so that they aren't made smaller by flushes
+        if (threads > 1) return 0;
         if (pptr() && pptr() > pbase()) return process(false);
         return 0;
     }
@@ -446,8 +944,19 @@ int zip_streambuf_compress::overflow(int c)
 }
 
 ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+    : ozstream(stream, 1)
+{
+}
+
+ozstream::ozstream(std::ostream &stream, std::size_t compression_threads)
+    : destination_stream_(stream),
+      compression_threads_(compression_threads)
 {
+    if (compression_threads_ == 0)
+    {
+        compression_threads_ = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
     if (!destination_stream_)
     {
         throw xlnt::exception("bad zip stream");
@@ -466,23 +975,58 @@ ozstream::~ozstream()
 
     std::ios::streampos central_end = destination_stream_.tellp();
 
+    const auto num_files = static_cast<std::uint64_t>(file_headers_.size());
+    const auto central_size = static_cast<std::uint64_t>(central_end - final_position);
+    const auto central_offset = static_cast<std::uint64_t>(final_position);
+
+    // Write ZIP64 end of central and its locator if any field overflows the regular end of central
+    if (num_files >= 0xffff || central_size >= zip64_marker || central_offset >= zip64_marker)
+    {
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x06064b50)); // zip64 end of central
+        write_int(destination_stream_, static_cast<std::uint64_t>(44)); // size of remaining record
+        write_int(destination_stream_, zip64_version); // version made by
+        write_int(destination_stream_, zip64_version); // version needed
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // this disk number
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with central directory
+        write_int(destination_stream_, num_files); // entries in center in this disk
+        write_int(destination_stream_, num_files); // entries in center
+        write_int(destination_stream_, central_size); // size of header
+        write_int(destination_stream_, central_offset); // offset to header
+
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x07064b50)); // zip64 end of central locator
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with zip64 end of central
+        write_int(destination_stream_, static_cast<std::uint64_t>(central_end)); // offset to zip64 end of central
+        write_int(destination_stream_, static_cast<std::uint32_t>(1)); // total number of disks
+    }
+
     // Write end of central
     write_int(destination_stream_, static_cast<std::uint32_t>(0x06054b50)); // end of central
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center in this disk
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center
-    write_int(destination_stream_, static_cast<std::uint32_t>(central_end - final_position)); // size of header
-    write_int(destination_stream_, static_cast<std::uint32_t>(final_position)); // offset to header
+    write_int(destination_stream_, static_cast<std::uint16_t>(std::min<std::uint64_t>(num_files, 0xffff))); // entries in center in this disk
+    write_int(destination_stream_, static_cast<std::uint16_t>(std::min<std::uint64_t>(num_files, 0xffff))); // entries in center
+    write_int(destination_stream_, static_cast<std::uint32_t>(std::min<std::uint64_t>(central_size, zip64_marker))); // size of header
+    write_int(destination_stream_, static_cast<std::uint32_t>(std::min<std::uint64_t>(central_offset, zip64_marker))); // offset to header
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // zip comment
 }
 
 std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
 {
+    return open(filename, 6, compression_strategy::default_strategy);
+}
+
+std::unique_ptr<std::streambuf> ozstream::open(const path &filename, int level, compression_strategy strategy)
+{
+    if (level < 0 || level > 9)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
     zheader header;
     header.filename = filename.string();
     file_headers_.push_back(header);
-    return std::make_unique<zip_streambuf_compress>(&file_headers_.back(), destination_stream_);
+    return std::make_unique<zip_streambuf_compress>(
+        &file_headers_.back(), destination_stream_, compression_threads_, level, zlib_strategy(strategy));
 }
 
 izstream::izstream(std::istream &stream)
@@ -496,6 +1040,16 @@ izstream::izstream(std::istream &stream)
     read_central_header();
 }
 
+izstream::izstream(const std::uint8_t *data, std::size_t size)
+    : data_(data),
+      size_(size),
+      memory_buffer_(new memory_istreambuf(data, size)),
+      memory_stream_(new std::istream(memory_buffer_.get())),
+      source_stream_(*memory_stream_)
+{
+    read_central_header();
+}
+
 izstream::~izstream()
 {
 }
@@ -552,7 +1106,8 @@ bool izstream::read_central_header()
     }
 
     // seek to end of central header and read
-    source_stream_.seekg(end_position - (read_start - static_cast<std::ptrdiff_t>(header_index)));
+    const std::streampos end_of_central = end_position - (read_start - static_cast<std::ptrdiff_t>(header_index));
+    source_stream_.seekg(end_of_central);
 
     /*auto word = */ read_int<std::uint32_t>(source_stream_);
     auto disk_number1 = read_int<std::uint16_t>(source_stream_);
@@ -563,21 +1118,57 @@ bool izstream::read_central_header()
         throw xlnt::exception("multiple disk zip files are not supported");
     }
 
-    auto num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
-    auto num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
+    std::uint64_t num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
+    std::uint64_t num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
+
+    /*auto size_of_header = */ read_int<std::uint32_t>(source_stream_); // size of header
+    std::uint64_t header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
+
+    // a ZIP64 end of central locator immediately precedes the end of central if present
+    const std::streamoff zip64_locator_size = 20;
+
+    if (end_of_central >= zip64_locator_size)
+    {
+        source_stream_.seekg(end_of_central - zip64_locator_size);
+
+        if (read_int<std::uint32_t>(source_stream_) == 0x07064b50)
+        {
+            /*auto zip64_disk_number = */ read_int<std::uint32_t>(source_stream_);
+            auto zip64_end_of_central = read_int<std::uint64_t>(source_stream_);
+            source_stream_.seekg(static_cast<std::streamoff>(zip64_end_of_central));
+
+            if (read_int<std::uint32_t>(source_stream_) != 0x06064b50)
+            {
+                throw xlnt::exception("missing ZIP64 end of central directory signature");
+            }
+
+            /*auto record_size = */ read_int<std::uint64_t>(source_stream_);
+            /*auto version_made_by = */ read_int<std::uint16_t>(source_stream_);
+            /*auto version_needed = */ read_int<std::uint16_t>(source_stream_);
+            disk_number1 = static_cast<std::uint16_t>(read_int<std::uint32_t>(source_stream_));
+            disk_number2 = static_cast<std::uint16_t>(read_int<std::uint32_t>(source_stream_));
+
+            if (disk_number1 != disk_number2 || disk_number1 != 0)
+            {
+                throw xlnt::exception("multiple disk zip files are not supported");
+            }
+
+            num_files = read_int<std::uint64_t>(source_stream_);
+            num_files_this_disk = read_int<std::uint64_t>(source_stream_);
+            /*auto size_of_header = */ read_int<std::uint64_t>(source_stream_);
+            header_offset = read_int<std::uint64_t>(source_stream_);
+        }
+    }
 
     if (num_files != num_files_this_disk)
     {
         throw xlnt::exception("multi disk zip files are not supported");
     }
 
-    /*auto size_of_header = */ read_int<std::uint32_t>(source_stream_); // size of header
-    auto header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
-
     // go to header and read all file headers
-    source_stream_.seekg(header_offset);
+    source_stream_.seekg(static_cast<std::streamoff>(header_offset));
 
-    for (std::uint16_t i = 0; i < num_files; ++i)
+    for (std::uint64_t i = 0; i < num_files; ++i)
     {
         auto header = read_header(source_stream_, true);
         file_headers_[header.filename] = header;
@@ -594,10 +1185,49 @@ std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
     }
 
     auto header = file_headers_.at(filename.string());
-    source_stream_.seekg(header.header_offset);
+
+    if (data_ != nullptr)
+    {
+        return std::make_unique<zip_streambuf_decompress_memory>(data_, size_, header);
+    }
+
+    source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
     return std::make_unique<zip_streambuf_decompress>(source_stream_, header);
 }
 
+std::unique_ptr<std::streambuf> izstream::open_detached(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    auto header = file_headers_.at(filename.string());
+
+    // an archive held in memory is never modified so it can be read from any thread
+    if (data_ != nullptr)
+    {
+        return std::make_unique<zip_streambuf_decompress_memory>(data_, size_, header);
+    }
+
+    // the local header can have a different length from the central one so read it to find out
+    source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
+    read_header(source_stream_, false);
+    const auto local_header_size = static_cast<std::uint64_t>(source_stream_.tellg()) - header.header_offset;
+    const auto data_size = header.compression_type == 0 ? header.uncompressed_size : header.compressed_size;
+
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(local_header_size + data_size));
+    source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
+    source_stream_.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    if (static_cast<std::size_t>(source_stream_.gcount()) != bytes.size())
+    {
+        throw xlnt::exception("unexpected end of ZIP file");
+    }
+
+    return std::make_unique<zip_streambuf_decompress_detached>(std::move(bytes), header);
+}
+
 std::string izstream::read(const path &filename) const
 {
     auto buffer = open(filename);
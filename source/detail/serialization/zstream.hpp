@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/save_options.hpp>
 
 //TODO: don't export these classes (some tests are using them for now)
 
@@ -60,12 +61,12 @@ struct XLNT_API zheader
     std::uint16_t stamp_date = 0;
     std::uint16_t stamp_time = 0;
     std::uint32_t crc = 0;
-    std::uint32_t compressed_size = 0;
-    std::uint32_t uncompressed_size = 0;
+    std::uint64_t compressed_size = 0;
+    std::uint64_t uncompressed_size = 0;
     std::string filename;
     std::string comment;
     std::vector<std::uint8_t> extra;
-    std::uint32_t header_offset = 0;
+    std::uint64_t header_offset = 0;
 };
 
 /// <summary>
@@ -80,6 +81,13 @@ public:
     /// </summary>
     ozstream(std::ostream &stream);
 
+    /// <summary>
+    /// Construct a new zip_file_writer which writes a ZIP archive to the given stream,
+    /// compressing each file with up to compression_threads threads. 0 uses one
+    /// thread per hardware thread.
+    /// </summary>
+    ozstream(std::ostream &stream, std::size_t compression_threads);
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -90,9 +98,17 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives at
+    /// the given DEFLATE level using the given strategy. Level 0 stores the data
+    /// without compression.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open(const path &file, int level, compression_strategy strategy);
+
 private:
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
+    std::size_t compression_threads_;
 };
 
 /// <summary>
@@ -107,6 +123,14 @@ public:
     /// </summary>
     izstream(std::istream &stream);
 
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive held in memory,
+    /// such as a mapped file. The memory must stay valid and unchanged for the
+    /// lifetime of this object and of any streambufs it returns. Compressed data
+    /// is inflated directly from this memory and stored files are read in place.
+    /// </summary>
+    izstream(const std::uint8_t *data, std::size_t size);
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -117,6 +141,14 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file) const;
 
+    /// <summary>
+    /// Copies the compressed data of file into memory and returns a streambuf
+    /// which decompresses it. Unlike open, the returned streambuf doesn't read
+    /// from the archive's stream, so it can be used on another thread while
+    /// other files are read from this archive.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_detached(const path &file) const;
+
     /// <summary>
     ///
     /// </summary>
@@ -143,6 +175,26 @@ private:
     /// </summary>
     std::unordered_map<std::string, zheader> file_headers_;
 
+    /// <summary>
+    /// The archive held in memory or nullptr if it is read from a stream.
+    /// </summary>
+    const std::uint8_t *data_ = nullptr;
+
+    /// <summary>
+    /// The size of the archive held in memory.
+    /// </summary>
+    std::size_t size_ = 0;
+
+    /// <summary>
+    /// The streambuf that source_stream_ uses to read an archive held in memory.
+    /// </summary>
+    std::unique_ptr<std::streambuf> memory_buffer_;
+
+    /// <summary>
+    /// The stream that source_stream_ refers to for an archive held in memory.
+    /// </summary>
+    std::unique_ptr<std::istream> memory_stream_;
+
     /// <summary>
     ///
     /// </summary>
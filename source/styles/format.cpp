@@ -37,6 +37,7 @@ format::format(detail::format_impl *d)
 void format::clear_style()
 {
     d_->style.clear();
+    d_->parent->format_index.clear();
 }
 
 format format::style(const xlnt::style &new_style)
@@ -48,6 +49,7 @@ format format::style(const xlnt::style &new_style)
 format format::style(const std::string &new_style)
 {
     d_->style = new_style;
+    d_->parent->format_index.clear();
     return format(d_);
 }
 
@@ -194,6 +196,7 @@ bool format::pivot_button() const
 void format::pivot_button(bool show)
 {
     d_->pivot_button_ = show;
+    d_->parent->format_index.clear();
 }
 
 bool format::quote_prefix() const
@@ -204,6 +207,12 @@ bool format::quote_prefix() const
 void format::quote_prefix(bool quote)
 {
     d_->quote_prefix_ = quote;
+    d_->parent->format_index.clear();
+}
+
+std::size_t format::id() const
+{
+    return d_->id;
 }
 
 
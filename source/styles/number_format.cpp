@@ -316,14 +316,12 @@ std::size_t number_format::id() const
 
 bool number_format::is_date_format() const
 {
-    detail::number_format_parser p(format_string_);
-    p.parse();
-    auto parsed = p.result();
+    const auto parsed = detail::compiled_number_format(format_string_);
 
     bool any_datetime = false;
     bool any_timedelta = false;
 
-    for (const auto &section : parsed)
+    for (const auto &section : *parsed)
     {
         if (section.is_datetime)
         {
@@ -349,6 +347,18 @@ std::string number_format::format(long double number, calendar base_date) const
     return detail::number_formatter(format_string_, base_date).format_number(number);
 }
 
+void number_format::format(const std::string &text, std::string &result) const
+{
+    result.clear();
+    detail::number_formatter(format_string_, calendar::windows_1900).format_text(text, result);
+}
+
+void number_format::format(long double number, calendar base_date, std::string &result) const
+{
+    result.clear();
+    detail::number_formatter(format_string_, base_date).format_number(number, result);
+}
+
 bool number_format::operator==(const number_format &other) const
 {
     return format_string_ == other.format_string_;
@@ -0,0 +1,144 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <detail/serialization/open_stream.hpp>
+#include <detail/serialization/xlsx_consumer.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/streaming_reader.hpp>
+#include <xlnt/workbook/workbook.hpp>
+
+namespace xlnt {
+
+streaming_reader::streaming_reader()
+{
+}
+
+streaming_reader::~streaming_reader()
+{
+    close();
+}
+
+void streaming_reader::open(const std::string &filename)
+{
+    open(path(filename));
+}
+
+void streaming_reader::open(const xlnt::path &filename)
+{
+    close();
+
+    file_.reset(new std::ifstream());
+    detail::open_stream(*file_, filename.string());
+
+    if (!file_->good())
+    {
+        file_.reset();
+        throw xlnt::exception("file not found " + filename.string());
+    }
+
+    open(*file_);
+}
+
+void streaming_reader::open(std::istream &stream)
+{
+    if (consumer_ != nullptr)
+    {
+        consumer_->end_worksheet();
+        consumer_.reset();
+    }
+
+    workbook_.reset(new xlnt::workbook());
+    consumer_.reset(new detail::xlsx_consumer(*workbook_));
+    consumer_->open(stream);
+}
+
+void streaming_reader::close()
+{
+    if (consumer_ != nullptr)
+    {
+        consumer_->end_worksheet();
+    }
+
+    consumer_.reset();
+    workbook_.reset();
+    file_.reset();
+    row_.cells.clear();
+}
+
+std::vector<std::string> streaming_reader::sheet_titles() const
+{
+    if (consumer_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    return consumer_->sheet_titles();
+}
+
+void streaming_reader::begin_worksheet(const std::string &title)
+{
+    if (consumer_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    consumer_->begin_worksheet(title);
+}
+
+bool streaming_reader::has_row()
+{
+    return consumer_ != nullptr && consumer_->has_row();
+}
+
+const streamed_row &streaming_reader::read_row()
+{
+    if (consumer_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    consumer_->read_row(row_);
+
+    return row_;
+}
+
+void streaming_reader::end_worksheet()
+{
+    if (consumer_ != nullptr)
+    {
+        consumer_->end_worksheet();
+    }
+}
+
+const workbook &streaming_reader::workbook() const
+{
+    if (workbook_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    return *workbook_;
+}
+
+} // namespace xlnt
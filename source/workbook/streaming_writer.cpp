@@ -0,0 +1,157 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <detail/serialization/open_stream.hpp>
+#include <detail/serialization/xlsx_producer.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/streaming_writer.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+
+namespace xlnt {
+
+streaming_writer::streaming_writer()
+{
+}
+
+streaming_writer::~streaming_writer()
+{
+    // destructors shouldn't throw, call close() explicitly to handle errors
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void streaming_writer::open(const std::string &filename)
+{
+    open(path(filename));
+}
+
+void streaming_writer::open(const xlnt::path &filename)
+{
+    close();
+
+    file_.reset(new std::ofstream());
+    detail::open_stream(*file_, filename.string());
+
+    if (!file_->good())
+    {
+        file_.reset();
+        throw xlnt::exception("could not open file for writing " + filename.string());
+    }
+
+    open(*file_);
+}
+
+void streaming_writer::open(std::ostream &stream)
+{
+    if (producer_ != nullptr)
+    {
+        close();
+    }
+
+    workbook_.reset(new xlnt::workbook());
+    producer_.reset(new detail::xlsx_producer(*workbook_));
+    producer_->open(stream);
+    default_worksheet_unused_ = true;
+}
+
+void streaming_writer::close()
+{
+    if (producer_ != nullptr)
+    {
+        producer_->close();
+    }
+
+    producer_.reset();
+    workbook_.reset();
+    file_.reset();
+}
+
+void streaming_writer::begin_worksheet(const std::string &title)
+{
+    if (producer_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    producer_->end_worksheet();
+
+    if (default_worksheet_unused_)
+    {
+        workbook_->active_sheet().title(title);
+        default_worksheet_unused_ = false;
+    }
+    else
+    {
+        workbook_->create_sheet().title(title);
+    }
+
+    producer_->begin_worksheet(title);
+}
+
+void streaming_writer::append_row(const streamed_row &row)
+{
+    if (producer_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    shared_string_indices_.clear();
+
+    for (const auto &cell : row.cells)
+    {
+        if (cell.type == cell_type::shared_string)
+        {
+            shared_string_indices_.push_back(workbook_->add_shared_string(rich_text(cell.text)));
+        }
+    }
+
+    producer_->write_row(row, shared_string_indices_);
+}
+
+void streaming_writer::end_worksheet()
+{
+    if (producer_ != nullptr)
+    {
+        producer_->end_worksheet();
+    }
+}
+
+workbook &streaming_writer::workbook()
+{
+    if (workbook_ == nullptr)
+    {
+        throw xlnt::exception("no file open");
+    }
+
+    return *workbook_;
+}
+
+} // namespace xlnt
@@ -34,6 +34,8 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
@@ -51,8 +53,10 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
@@ -63,38 +67,6 @@
 
 namespace {
 
-#ifdef _MSC_VER
-void open_stream(std::ifstream &stream, const std::wstring &path)
-{
-    stream.open(path, std::ios::binary);
-}
-
-void open_stream(std::ofstream &stream, const std::wstring &path)
-{
-    stream.open(path, std::ios::binary);
-}
-
-void open_stream(std::ifstream &stream, const std::string &path)
-{
-    open_stream(stream, xlnt::path(path).wstring());
-}
-
-void open_stream(std::ofstream &stream, const std::string &path)
-{
-    open_stream(stream, xlnt::path(path).wstring());
-}
-#else
-void open_stream(std::ifstream &stream, const std::string &path)
-{
-    stream.open(path, std::ios::binary);
-}
-
-void open_stream(std::ofstream &stream, const std::string &path)
-{
-    stream.open(path, std::ios::binary);
-}
-#endif
-
 template<typename T>
 std::vector<T> keys(const std::vector<std::pair<T, xlnt::variant>> &container)
 {
@@ -282,6 +254,88 @@ std::string content_type(xlnt::relationship_type type)
     default_case("application/xml");
 }
 
+/// <summary>
+/// Adds a reference to the format of every cell in ws, which is a new copy of
+/// another worksheet and so shares its formats.
+/// </summary>
+void reference_formats(xlnt::detail::worksheet_impl &ws)
+{
+    for (const auto &row : ws.cells_.rows())
+    {
+        for (const auto &cell : row.cells)
+        {
+            if (cell.impl->format_ != nullptr)
+            {
+                ++cell.impl->format_->references;
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Releases the reference of every cell in ws to its format before ws is removed.
+/// </summary>
+void release_formats(xlnt::detail::worksheet_impl &ws)
+{
+    for (const auto &row : ws.cells_.rows())
+    {
+        for (const auto &cell : row.cells)
+        {
+            if (cell.impl->format_ != nullptr)
+            {
+                cell.impl->format_->parent->release_format(*cell.impl->format_);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Reads ws if it was deferred by a lazy load and releases the workbook's
+/// reader once every worksheet has been read.
+/// </summary>
+void read_deferred_worksheet(xlnt::detail::workbook_impl &wb, xlnt::detail::worksheet_impl &ws)
+{
+    if (!wb.worksheet_reader_) return;
+
+    // held here since reading the last worksheet releases the workbook's reference
+    auto reader = wb.worksheet_reader_;
+    reader->read_deferred_worksheet(&ws);
+
+    if (!reader->has_deferred_worksheets())
+    {
+        wb.worksheet_reader_.reset();
+    }
+}
+
+/// <summary>
+/// Forgets ws, which is about to be removed, if it was deferred by a lazy load
+/// and releases the workbook's reader if no other worksheet is left unread.
+/// </summary>
+void forget_deferred_worksheet(xlnt::detail::workbook_impl &wb, xlnt::detail::worksheet_impl &ws)
+{
+    if (!wb.worksheet_reader_) return;
+
+    auto reader = wb.worksheet_reader_;
+    reader->forget_deferred_worksheet(&ws);
+
+    if (!reader->has_deferred_worksheets())
+    {
+        wb.worksheet_reader_.reset();
+    }
+}
+
+/// <summary>
+/// Reads every worksheet deferred by a lazy load and releases the workbook's reader.
+/// </summary>
+void read_deferred_worksheets(xlnt::detail::workbook_impl &wb)
+{
+    if (!wb.worksheet_reader_) return;
+
+    auto reader = wb.worksheet_reader_;
+    reader->read_deferred_worksheets();
+    wb.worksheet_reader_.reset();
+}
+
 } // namespace
 
 namespace xlnt {
@@ -628,6 +682,7 @@ const worksheet workbook::sheet_by_title(const std::string &title) const
     {
         if (impl.title_ == title)
         {
+            read_deferred_worksheet(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -641,6 +696,7 @@ worksheet workbook::sheet_by_title(const std::string &title)
     {
         if (impl.title_ == title)
         {
+            read_deferred_worksheet(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -662,6 +718,7 @@ worksheet workbook::sheet_by_index(std::size_t index)
         ++iter;
     }
 
+    read_deferred_worksheet(*d_, *iter);
     return worksheet(&*iter);
 }
 
@@ -673,6 +730,7 @@ const worksheet workbook::sheet_by_index(std::size_t index) const
     {
     }
 
+    read_deferred_worksheet(*d_, *iter);
     return worksheet(&*iter);
 }
 
@@ -682,6 +740,7 @@ worksheet workbook::sheet_by_id(std::size_t id)
     {
         if (impl.id_ == id)
         {
+            read_deferred_worksheet(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -695,6 +754,7 @@ const worksheet workbook::sheet_by_id(std::size_t id) const
     {
         if (impl.id_ == id)
         {
+            read_deferred_worksheet(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -756,6 +816,7 @@ worksheet workbook::copy_sheet(worksheet to_copy)
     auto new_sheet = create_sheet();
     impl.title_ = new_sheet.title();
     *new_sheet.d_ = impl;
+    reference_formats(*new_sheet.d_);
 
     return new_sheet;
 }
@@ -854,15 +915,58 @@ void workbook::load(const std::string &filename)
 
 void workbook::load(const path &filename)
 {
+    load(filename, load_options());
+}
+
+void workbook::load(const path &filename, const load_options &options)
+{
+    std::unique_ptr<detail::mapped_file> mapped(new detail::mapped_file(filename.string()));
+
+    if (mapped->is_open())
+    {
+        clear();
+        auto consumer = std::make_shared<detail::xlsx_consumer>(*this);
+
+        if (options.lazy_worksheets)
+        {
+            // the consumer keeps the mapping open until every worksheet is read
+            consumer->read(std::move(mapped), options);
+        }
+        else
+        {
+            consumer->read(mapped->data(), mapped->size(), options);
+        }
+
+        if (consumer->has_deferred_worksheets())
+        {
+            d_->worksheet_reader_ = consumer;
+        }
+
+        return;
+    }
+
+    // fall back to reading through a stream if the file can't be mapped
     std::ifstream file_stream;
-    open_stream(file_stream, filename.string());
+    detail::open_stream(file_stream, filename.string());
 
     if (!file_stream.good())
     {
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    load(file_stream);
+    load(file_stream, options);
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
+{
+    clear();
+    auto consumer = std::make_shared<detail::xlsx_consumer>(*this);
+    consumer->read(stream, options);
+
+    if (consumer->has_deferred_worksheets())
+    {
+        d_->worksheet_reader_ = consumer;
+    }
 }
 
 void workbook::load(const std::string &filename, const std::string &password)
@@ -873,7 +977,7 @@ void workbook::load(const std::string &filename, const std::string &password)
 void workbook::load(const path &filename, const std::string &password)
 {
     std::ifstream file_stream;
-    open_stream(file_stream, filename.string());
+    detail::open_stream(file_stream, filename.string());
 
     if (!file_stream.good())
     {
@@ -929,25 +1033,47 @@ void workbook::save(const std::string &filename, const std::string &password) co
 void workbook::save(const path &filename) const
 {
     std::ofstream file_stream;
-    open_stream(file_stream, filename.string());
+    detail::open_stream(file_stream, filename.string());
     save(file_stream);
 }
 
 void workbook::save(const path &filename, const std::string &password) const
 {
     std::ofstream file_stream;
-    open_stream(file_stream, filename.string());
+    detail::open_stream(file_stream, filename.string());
     save(file_stream, password);
 }
 
+void workbook::save(const path &filename, const save_options &options) const
+{
+    std::ofstream file_stream;
+    detail::open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    read_deferred_worksheets(*d_);
+
+    if (options.compact_styles && d_->stylesheet_.is_set())
+    {
+        d_->stylesheet_.get().garbage_collect();
+    }
+
+    detail::xlsx_producer producer(*this);
+    producer.write(stream, options);
+}
+
 void workbook::save(std::ostream &stream) const
 {
+    read_deferred_worksheets(*d_);
     detail::xlsx_producer producer(*this);
     producer.write(stream);
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    read_deferred_worksheets(*d_);
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
@@ -956,28 +1082,28 @@ void workbook::save(std::ostream &stream, const std::string &password) const
 void workbook::save(const std::wstring &filename) const
 {
     std::ofstream file_stream;
-    open_stream(file_stream, filename);
+    detail::open_stream(file_stream, filename);
     save(file_stream);
 }
 
 void workbook::save(const std::wstring &filename, const std::string &password) const
 {
     std::ofstream file_stream;
-    open_stream(file_stream, filename);
+    detail::open_stream(file_stream, filename);
     save(file_stream, password);
 }
 
 void workbook::load(const std::wstring &filename)
 {
     std::ifstream file_stream;
-    open_stream(file_stream, filename);
+    detail::open_stream(file_stream, filename);
     load(file_stream);
 }
 
 void workbook::load(const std::wstring &filename, const std::string &password)
 {
     std::ifstream file_stream;
-    open_stream(file_stream, filename);
+    detail::open_stream(file_stream, filename);
     load(file_stream, password);
 }
 #endif
@@ -999,6 +1125,8 @@ void workbook::remove_sheet(worksheet ws)
     d_->manifest_.unregister_override_type(ws_part);
     auto rel_id_map = d_->manifest_.unregister_relationship(wb_rel.target(), ws_rel_id);
     d_->sheet_title_rel_id_map_.erase(ws.title());
+    release_formats(*match_iter);
+    forget_deferred_worksheet(*d_, *match_iter);
     d_->worksheets_.erase(match_iter);
 
     // Shift sheet title->ID mappings down as a result of manifest::unregister_relationship above.
@@ -1107,6 +1235,8 @@ worksheet workbook::operator[](std::size_t index)
 
 void workbook::clear()
 {
+    // not copied by the assignment below
+    d_->worksheet_reader_.reset();
     *d_ = detail::workbook_impl();
     d_->stylesheet_.clear();
 }
@@ -1128,11 +1258,12 @@ void workbook::swap(workbook &right)
     using std::swap;
     swap(left.d_, right.d_);
 
+    // set directly since iterating would read any deferred worksheets
     if (left.d_ != nullptr)
     {
-        for (auto ws : left)
+        for (auto &impl : left.d_->worksheets_)
         {
-            ws.parent(left);
+            impl.parent_ = &left;
         }
 
         if (left.d_->stylesheet_.is_set())
@@ -1143,9 +1274,9 @@ void workbook::swap(workbook &right)
 
     if (right.d_ != nullptr)
     {
-        for (auto ws : right)
+        for (auto &impl : right.d_->worksheets_)
         {
-            ws.parent(right);
+            impl.parent_ = &right;
         }
 
         if (right.d_->stylesheet_.is_set())
@@ -1172,6 +1303,7 @@ workbook::workbook(workbook &&other)
 workbook::workbook(const workbook &other)
     : workbook()
 {
+    read_deferred_worksheets(*other.d_);
     *d_.get() = *other.d_.get();
 
     for (auto ws : *this)
@@ -1223,6 +1355,14 @@ format workbook::create_format(bool default_format)
     return d_->stylesheet_.get().create_format(default_format);
 }
 
+void workbook::compact_styles()
+{
+    if (d_->stylesheet_.is_set())
+    {
+        d_->stylesheet_.get().garbage_collect();
+    }
+}
+
 bool workbook::has_style(const std::string &name) const
 {
     return d_->stylesheet_.get().has_style(name);
@@ -1277,6 +1417,8 @@ const manifest &workbook::manifest() const
 
 std::vector<rich_text> &workbook::shared_strings()
 {
+    // the caller may change strings in place, so add_shared_string rebuilds the index
+    d_->shared_string_ids_.clear();
     return d_->shared_strings_;
 }
 
@@ -1289,25 +1431,48 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 {
     register_workbook_part(relationship_type::shared_string_table);
 
-    auto index = std::size_t(0);
+    auto &strings = d_->shared_strings_;
+    auto &ids = d_->shared_string_ids_;
+    static const auto hasher = std::hash<rich_text>();
+
+    // shared_strings() empties the index whenever it hands out the table, so
+    // this only indexes strings added since, or everything after such a call
+    if (ids.size() > strings.size())
+    {
+        ids.clear();
+    }
+
+    for (auto i = ids.size(); i < strings.size(); ++i)
+    {
+        ids.emplace(hasher(strings[i]), i);
+    }
+
+    const auto hash = hasher(shared);
 
     if (!allow_duplicates)
     {
-        // TODO: inefficient, use a set or something?
-        for (auto &s : d_->shared_strings_)
+        auto match = strings.size();
+        auto candidates = ids.equal_range(hash);
+
+        for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
         {
-            if (s == shared)
+            // prefer the first occurrence if the table has duplicates
+            if (candidate->second < match && strings[candidate->second] == shared)
             {
-                return index;
+                match = candidate->second;
             }
+        }
 
-            ++index;
+        if (match != strings.size())
+        {
+            return match;
         }
     }
 
-    d_->shared_strings_.push_back(shared);
+    ids.emplace(hash, strings.size());
+    strings.push_back(shared);
 
-    return index;
+    return strings.size() - 1;
 }
 
 bool workbook::contains(const std::string &sheet_title) const
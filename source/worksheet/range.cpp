@@ -22,6 +22,7 @@
 // @author: see AUTHORS file
 
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/styles/format.hpp>
 #include <xlnt/styles/style.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/range.hpp>
@@ -96,43 +97,43 @@ bool range::contains(const cell_reference &ref)
 
 range range::alignment(const xlnt::alignment &new_alignment)
 {
-    apply([&new_alignment](class cell c) { c.alignment(new_alignment); });
+    ws_.restyle(ref_, skip_null_, [&new_alignment](xlnt::format f) { return f.alignment(new_alignment, true); });
     return *this;
 }
 
 range range::border(const xlnt::border &new_border)
 {
-    apply([&new_border](class cell c) { c.border(new_border); });
+    ws_.restyle(ref_, skip_null_, [&new_border](xlnt::format f) { return f.border(new_border, true); });
     return *this;
 }
 
 range range::fill(const xlnt::fill &new_fill)
 {
-    apply([&new_fill](class cell c) { c.fill(new_fill); });
+    ws_.restyle(ref_, skip_null_, [&new_fill](xlnt::format f) { return f.fill(new_fill, true); });
     return *this;
 }
 
 range range::font(const xlnt::font &new_font)
 {
-    apply([&new_font](class cell c) { c.font(new_font); });
+    ws_.restyle(ref_, skip_null_, [&new_font](xlnt::format f) { return f.font(new_font, true); });
     return *this;
 }
 
 range range::number_format(const xlnt::number_format &new_number_format)
 {
-    apply([&new_number_format](class cell c) { c.number_format(new_number_format); });
+    ws_.restyle(ref_, skip_null_, [&new_number_format](xlnt::format f) { return f.number_format(new_number_format, true); });
     return *this;
 }
 
 range range::protection(const xlnt::protection &new_protection)
 {
-    apply([&new_protection](class cell c) { c.protection(new_protection); });
+    ws_.restyle(ref_, skip_null_, [&new_protection](xlnt::format f) { return f.protection(new_protection, true); });
     return *this;
 }
 
 range range::style(const class style &new_style)
 {
-    apply([&new_style](class cell c) { c.style(new_style); });
+    ws_.restyle(ref_, skip_null_, [&new_style](xlnt::format f) { return f.style(new_style); });
     return *this;
 }
 
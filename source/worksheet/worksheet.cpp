@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <unordered_map>
 
 #include <detail/constants.hpp>
 #include <detail/implementations/cell_impl.hpp>
@@ -196,33 +197,11 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_map_iter = d_->cell_map_.begin();
-
-    while (cell_map_iter != d_->cell_map_.end())
-    {
-        auto cell_iter = cell_map_iter->second.begin();
-
-        while (cell_iter != cell_map_iter->second.end())
-        {
-            class cell current_cell(&cell_iter->second);
-
-            if (current_cell.garbage_collectible())
-            {
-                cell_iter = cell_map_iter->second.erase(cell_iter);
-                continue;
-            }
-
-            cell_iter++;
-        }
-
-        if (cell_map_iter->second.empty())
-        {
-            cell_map_iter = d_->cell_map_.erase(cell_map_iter);
-            continue;
-        }
-
-        cell_map_iter++;
-    }
+    d_->cells_.erase_if([](detail::cell_impl &impl) {
+        if (!xlnt::cell(&impl).garbage_collectible()) return false;
+        impl.clear_attributes();
+        return true;
+    });
 }
 
 void worksheet::id(std::size_t id)
@@ -352,27 +331,26 @@ void worksheet::unfreeze_panes()
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    if (d_->cell_map_.find(reference.row()) == d_->cell_map_.end())
-    {
-        d_->cell_map_[reference.row()] = std::unordered_map<column_t, detail::cell_impl>();
-    }
+    auto result = d_->cells_.emplace(reference.row(), reference.column_index());
 
-    auto &row = d_->cell_map_[reference.row()];
-
-    if (row.find(reference.column_index()) == row.end())
+    if (result.second)
     {
-        auto &impl = row[reference.column_index()] = detail::cell_impl();
-        impl.parent_ = d_;
-        impl.column_ = reference.column_index();
-        impl.row_ = reference.row();
+        result.first->parent_ = d_;
     }
 
-    return xlnt::cell(&row[reference.column_index()]);
+    return xlnt::cell(result.first);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xlnt::cell(&d_->cell_map_.at(reference.row()).at(reference.column_index()));
+    auto impl = d_->cells_.find(reference.row(), reference.column_index());
+
+    if (impl == nullptr)
+    {
+        throw key_not_found();
+    }
+
+    return xlnt::cell(impl);
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -387,13 +365,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto row = d_->cell_map_.find(reference.row());
-    if (row == d_->cell_map_.cend()) return false;
-
-    const auto col = row->second.find(reference.column_index());
-    if (col == row->second.cend()) return false;
-
-    return true;
+    return d_->cells_.find(reference.row(), reference.column_index()) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -433,66 +405,42 @@ const range worksheet::named_range(const std::string &name) const
 
 column_t worksheet::lowest_column() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cells_.empty())
     {
         return constants::min_column();
     }
 
-    column_t lowest = constants::max_column();
-
-    for (auto &row : d_->cell_map_)
-    {
-        for (auto &c : row.second)
-        {
-            lowest = std::min(lowest, c.first);
-        }
-    }
-
-    return lowest;
+    return d_->cells_.lowest_column();
 }
 
 row_t worksheet::lowest_row() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cells_.empty())
     {
         return constants::min_row();
     }
 
-    row_t lowest = constants::max_row();
-
-    for (auto &row : d_->cell_map_)
-    {
-        lowest = std::min(lowest, row.first);
-    }
-
-    return lowest;
+    return d_->cells_.rows().front().row;
 }
 
 row_t worksheet::highest_row() const
 {
-    row_t highest = constants::min_row();
-
-    for (auto &row : d_->cell_map_)
+    if (d_->cells_.empty())
     {
-        highest = std::max(highest, row.first);
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cells_.rows().back().row;
 }
 
 column_t worksheet::highest_column() const
 {
-    column_t highest = constants::min_column();
-
-    for (auto &row : d_->cell_map_)
+    if (d_->cells_.empty())
     {
-        for (auto &c : row.second)
-        {
-            highest = std::max(highest, c.first);
-        }
+        return constants::min_column();
     }
 
-    return highest;
+    return d_->cells_.highest_column();
 }
 
 range_reference worksheet::calculate_dimension() const
@@ -592,7 +540,7 @@ row_t worksheet::next_row() const
 {
     auto row = highest_row() + 1;
 
-    if (row == 2 && d_->cell_map_.size() == 0)
+    if (row == 2 && d_->cells_.empty())
     {
         row = 1;
     }
@@ -650,22 +598,19 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     if (d_->parent_ != other.d_->parent_) return false;
 
-    for (auto &row : d_->cell_map_)
+    for (auto &row : d_->cells_.rows())
     {
-        if (other.d_->cell_map_.find(row.first) == other.d_->cell_map_.end())
+        for (auto &cell : row.cells)
         {
-            return false;
-        }
+            auto other_impl = other.d_->cells_.find(row.row, cell.column);
 
-        for (auto &cell : row.second)
-        {
-            if (other.d_->cell_map_[row.first].find(cell.first) == other.d_->cell_map_[row.first].end())
+            if (other_impl == nullptr)
             {
                 return false;
             }
 
-            xlnt::cell this_cell(&cell.second);
-            xlnt::cell other_cell(&other.d_->cell_map_[row.first][cell.first]);
+            xlnt::cell this_cell(cell.impl);
+            xlnt::cell other_cell(other_impl);
 
             if (this_cell.data_type() != other_cell.data_type())
             {
@@ -733,7 +678,7 @@ void worksheet::remove_named_range(const std::string &name)
 
 void worksheet::reserve(std::size_t n)
 {
-    d_->cell_map_.reserve(n);
+    d_->cells_.reserve(n);
 }
 
 class header_footer worksheet::header_footer() const
@@ -981,4 +926,72 @@ conditional_format worksheet::conditional_format(const range_reference &ref, con
 	return workbook().d_->stylesheet_.get().add_conditional_format_rule(d_, ref, when);
 }
 
+void worksheet::format(const range_reference &reference, const class format &new_format)
+{
+    restyle(reference, false, [&new_format](xlnt::format) { return new_format; });
+}
+
+void worksheet::restyle(const range_reference &reference, bool skip_null,
+    const std::function<class format(class format)> &derive)
+{
+    // cells are keyed by their current format, nullptr for unformatted cells
+    std::unordered_map<detail::format_impl *, detail::format_impl *> transitions;
+    auto previous_source = static_cast<detail::format_impl *>(nullptr);
+    auto previous_target = static_cast<detail::format_impl *>(nullptr);
+
+    const auto first_column = reference.top_left().column_index();
+    const auto last_column = reference.bottom_right().column_index();
+    const auto last_row = reference.bottom_right().row();
+
+    for (auto row = reference.top_left().row(); row <= last_row; ++row)
+    {
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            auto impl = static_cast<detail::cell_impl *>(nullptr);
+
+            if (skip_null)
+            {
+                impl = d_->cells_.find(row, column);
+                if (impl == nullptr) continue;
+            }
+            else
+            {
+                auto result = d_->cells_.emplace(row, column);
+                impl = result.first;
+                if (result.second) impl->parent_ = d_;
+            }
+
+            auto source = impl->format_;
+
+            // neighbouring cells usually share a format so skip the lookup
+            if (previous_target == nullptr || source != previous_source)
+            {
+                auto match = transitions.find(source);
+
+                if (match == transitions.end())
+                {
+                    auto pattern = source == nullptr
+                        ? workbook().create_format()
+                        : xlnt::format(source);
+                    match = transitions.emplace(source, derive(pattern).d_).first;
+                }
+
+                previous_source = source;
+                previous_target = match->second;
+            }
+
+            // counted as each cell changes so that they stay right if derive throws,
+            // incrementing first so that a format kept by the cell never drops to 0
+            ++previous_target->references;
+
+            if (source != nullptr)
+            {
+                source->parent->release_format(*source);
+            }
+
+            impl->format_ = previous_target;
+        }
+    }
+}
+
 } // namespace xlnt
@@ -63,9 +63,13 @@ public:
         register_test(test_print);
         register_test(test_values);
         register_test(test_reference);
+        register_test(test_reference_chars);
         register_test(test_anchor);
         register_test(test_hyperlink);
         register_test(test_comment);
+        register_test(test_copy);
+        register_test(test_value_text_follows_type);
+        register_test(test_copy_keeps_format);
     }
 
 private:
@@ -643,6 +647,41 @@ private:
         xlnt_assert(xlnt::cell_reference("A1") != "A2");
     }
 
+    void test_reference_chars()
+    {
+        auto column_only = xlnt::cell_reference("$C12");
+        xlnt_assert(column_only.column_absolute());
+        xlnt_assert(!column_only.row_absolute());
+        xlnt_assert_equals(column_only.to_string(), "$C12");
+
+        auto row_only = xlnt::cell_reference("c$12");
+        xlnt_assert(!row_only.column_absolute());
+        xlnt_assert(row_only.row_absolute());
+        xlnt_assert_equals(row_only.to_string(), "C$12");
+
+        const std::string attribute = "XFD1048576\"";
+        auto parsed = xlnt::cell_reference::from_chars(attribute.data(), attribute.data() + attribute.size() - 1);
+        xlnt_assert_equals(parsed, xlnt::cell_reference(16384, 1048576));
+
+        char buffer[19];
+        auto absolute = xlnt::cell_reference("$XFD$1048576");
+        xlnt_assert_equals(std::string(buffer, absolute.to_chars(buffer)), "$XFD$1048576");
+        xlnt_assert_equals(std::string(buffer, xlnt::cell_reference(28, 3).to_chars(buffer)), "AB3");
+
+        // the longest reference fills the documented minimum buffer
+        auto longest = xlnt::cell_reference(4294967295u, 4294967295u);
+        longest.make_absolute();
+        xlnt_assert_equals(std::string(buffer, longest.to_chars(buffer)), "$MWLQKWU$4294967295");
+        xlnt_assert_equals(longest.to_string(), "$MWLQKWU$4294967295");
+        xlnt_assert_equals(xlnt::column_t(20000).column_string(), "ACOF");
+
+        xlnt_assert_throws(xlnt::cell_reference("A-1"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("A$"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("A99999999999"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("ABCD1"), xlnt::invalid_column_index);
+        xlnt_assert_throws(xlnt::cell_reference("$1"), xlnt::invalid_column_index);
+    }
+
     void test_anchor()
     {
         xlnt::workbook wb;
@@ -679,4 +718,73 @@ private:
         xlnt_assert(!cell.has_comment());
         xlnt_assert_throws(cell.comment(), xlnt::exception);
     }
+
+    void test_copy()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        auto a1 = ws.cell("A1");
+        a1.formula("=SUM(B1:B2)");
+        a1.hyperlink("http://example.com");
+        ws.cell("A2").error("#REF!");
+
+        auto c1 = ws.cell("C1");
+        c1 = a1;
+        xlnt_assert_equals(c1.reference(), "C1");
+        xlnt_assert_equals(c1.formula(), "SUM(B1:B2)");
+        xlnt_assert_equals(c1.hyperlink(), "http://example.com");
+
+        a1.clear_formula();
+        xlnt_assert(!a1.has_formula());
+        xlnt_assert(c1.has_formula());
+
+        auto copy = wb.copy_sheet(ws);
+        xlnt_assert_equals(copy.cell("C1").formula(), "SUM(B1:B2)");
+        xlnt_assert_equals(copy.cell("A2").value<std::string>(), "#REF!");
+        xlnt_assert(!copy.cell("A1").has_formula());
+    }
+
+    void test_value_text_follows_type()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // text is dropped once the cell holds a value without text
+        auto a1 = ws.cell("A1");
+        a1.error("#REF!");
+        a1.value(1);
+        a1.data_type(xlnt::cell::type::error);
+        xlnt_assert_equals(a1.value<std::string>(), "");
+
+        auto a2 = ws.cell("A2");
+        a2.formula("=A1");
+        a2.error("#N/A");
+        a2.clear_value();
+        xlnt_assert(!a2.has_formula());
+        a2.data_type(xlnt::cell::type::error);
+        xlnt_assert_equals(a2.value<std::string>(), "");
+    }
+
+    void test_copy_keeps_format()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        auto a1 = ws.cell("A1");
+        a1.font(xlnt::font().bold(true));
+
+        auto b1 = ws.cell("B1");
+        b1.value(a1);
+        auto c1 = ws.cell("C1");
+        c1 = a1;
+
+        a1.clear_format();
+        wb.compact_styles();
+
+        xlnt_assert(b1.has_format());
+        xlnt_assert(b1.font().bold());
+        xlnt_assert(c1.has_format());
+        xlnt_assert(c1.font().bold());
+    }
 };
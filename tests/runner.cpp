@@ -39,7 +39,9 @@
 
 #include <workbook/named_range_test_suite.hpp>
 #include <workbook/serialization_test_suite.hpp>
+#include <workbook/streaming_test_suite.hpp>
 #include <workbook/workbook_test_suite.hpp>
+#include <workbook/zip_test_suite.hpp>
 
 #include <worksheet/page_setup_test_suite.hpp>
 #include <worksheet/range_test_suite.hpp>
@@ -93,7 +95,9 @@ int main()
     // workbook
     run_tests<named_range_test_suite>();
     run_tests<serialization_test_suite>();
+    run_tests<streaming_test_suite>();
     run_tests<workbook_test_suite>();
+    run_tests<zip_test_suite>();
 
     // worksheet
     run_tests<page_setup_test_suite>();
@@ -112,6 +112,8 @@ public:
         register_test(test_builtin_format_date_dmyminus);
         register_test(test_builtin_format_date_dmminus);
         register_test(test_builtin_format_date_myminus);
+        register_test(test_repeated_formatting);
+        register_test(test_format_into_buffer);
     }
 
     void test_basic()
@@ -977,4 +979,74 @@ public:
     {
         format_and_test(xlnt::number_format::date_myminus(), {{"5-16", "###########", "1-00", "text"}});
     }
+
+    void test_repeated_formatting()
+    {
+        xlnt::number_format nf("#,##0.00;[Red]-#,##0.00");
+        xlnt::number_format same("#,##0.00;[Red]-#,##0.00");
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            xlnt_assert_equals(nf.format(1234.5, xlnt::calendar::windows_1900), "1,234.50");
+            xlnt_assert_equals(same.format(-1234.5, xlnt::calendar::windows_1900), "-1,234.50");
+            xlnt_assert(!nf.is_date_format());
+        }
+
+        xlnt::number_format date("yyyy-mm-dd");
+        xlnt_assert(date.is_date_format());
+        xlnt_assert_equals(date.format(42000, xlnt::calendar::mac_1904), "2018-12-28");
+        xlnt_assert_equals(date.format(42000, xlnt::calendar::windows_1900), "2014-12-27");
+        xlnt_assert(date.is_date_format());
+
+        // invalid formats aren't cached and throw every time
+        xlnt::number_format invalid("[$-G]#,##0.00");
+        xlnt_assert_throws(invalid.format(1.2, xlnt::calendar::windows_1900), std::runtime_error);
+        xlnt_assert_throws(invalid.format(1.2, xlnt::calendar::windows_1900), std::runtime_error);
+    }
+
+    void test_format_into_buffer()
+    {
+        const auto calendar = xlnt::calendar::windows_1900;
+        std::string buffer = "left over from before";
+
+        xlnt::number_format::general().format(0.5, calendar, buffer);
+        xlnt_assert_equals(buffer, "0.5");
+        xlnt::number_format::number_00().format(-1, calendar, buffer);
+        xlnt_assert_equals(buffer, "-1.00");
+        xlnt::number_format::number_comma_separated1().format(123456789.25, calendar, buffer);
+        xlnt_assert_equals(buffer, "123,456,789.25");
+        xlnt::number_format::percentage_00().format(0.5, calendar, buffer);
+        xlnt_assert_equals(buffer, "50.00%");
+        xlnt::number_format::date_yyyymmdd2().format(42503.1234, calendar, buffer);
+        xlnt_assert_equals(buffer, "2016-05-13");
+        xlnt::number_format::date_time4().format(42503.1234, calendar, buffer);
+        xlnt_assert_equals(buffer, "2:57:42");
+        xlnt::number_format("#,##0 ;[Red](#,##0)").format(-42503.1234, calendar, buffer);
+        xlnt_assert_equals(buffer, "(42,503)");
+        xlnt::number_format("#,##0 ;[Red](#,##0)").format("text", buffer);
+        xlnt_assert_equals(buffer, "text");
+
+        xlnt::number_format comma("#,##0");
+        xlnt_assert_equals(comma.format(123456789, calendar), "123,456,789");
+        xlnt_assert_equals(comma.format(3000000000, calendar), "3,000,000,000");
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(3.5);
+        ws.cell("A2").value("text");
+        ws.cell("A3").value(true);
+
+        ws.cell("A1").to_string(buffer);
+        xlnt_assert_equals(buffer, "3.5");
+        ws.cell("A2").to_string(buffer);
+        xlnt_assert_equals(buffer, "text");
+        ws.cell("A3").to_string(buffer);
+        xlnt_assert_equals(buffer, "TRUE");
+        ws.cell("A4").to_string(buffer);
+        xlnt_assert_equals(buffer, "");
+
+        xlnt_assert_equals(ws.cell("A1").to_string(), "3.5");
+        xlnt_assert_equals(ws.cell("A3").to_string(), "TRUE");
+        xlnt_assert_equals(ws.cell("A4").to_string(), "");
+    }
 };
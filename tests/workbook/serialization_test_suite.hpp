@@ -23,14 +23,20 @@
 
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <regex>
 
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <detail/cryptography/xlsx_crypto_consumer.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
 #include <helpers/path_helper.hpp>
 #include <helpers/xml_helper.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/workbook.hpp>
 
 class serialization_test_suite : public test_suite
@@ -56,6 +62,18 @@ public:
         register_test(test_read_custom_properties);
         register_test(test_round_trip_rw);
         register_test(test_round_trip_rw_encrypted);
+        register_test(test_load_worksheets_concurrently);
+        register_test(test_load_merged_cells_concurrently);
+        register_test(test_load_lazy_worksheets);
+        register_test(test_remove_lazy_worksheet);
+        register_test(test_save_compression_threads);
+        register_test(test_save_compression_levels);
+        register_test(test_read_cells_without_references);
+        register_test(test_read_numbers);
+        register_test(test_read_sheet_data_markup);
+        register_test(test_write_sparse_worksheet);
+        register_test(test_write_shortest_numbers);
+        register_test(test_write_escaped_cell_text);
     }
 
 	bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -442,6 +460,283 @@ public:
         }
     }
 
+    void test_load_worksheets_concurrently()
+    {
+        const auto files = std::vector<std::string>
+        {
+            "4_every_style",
+            "10_comments_hyperlinks_formulae",
+            "11_print_settings"
+        };
+
+        xlnt::load_options options;
+        options.worksheet_threads = 4;
+
+        for (const auto file : files)
+        {
+            auto path = path_helper::test_file(file + ".xlsx");
+
+            xlnt::workbook source_workbook;
+            source_workbook.load(path, options);
+
+            std::vector<std::uint8_t> destination;
+            source_workbook.save(destination);
+
+            std::ifstream source_stream(path.string(), std::ios::binary);
+            xlnt_assert(xml_helper::xlsx_archives_match(xlnt::detail::to_vector(source_stream), destination));
+        }
+    }
+
+    void test_load_merged_cells_concurrently()
+    {
+        // merging a cell holding a shared string adds to the workbook's shared
+        // strings, which mustn't happen on the threads reading worksheets
+        xlnt::workbook source_workbook;
+
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            auto ws = i == 0 ? source_workbook.active_sheet() : source_workbook.create_sheet();
+
+            for (xlnt::row_t row = 1; row <= 2000; ++row)
+            {
+                ws.cell(1, row).value("left " + std::to_string(row));
+                ws.cell(2, row).value("right " + std::to_string(row));
+                ws.merge_cells(xlnt::range_reference(1, row, 2, row));
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        source_workbook.save(data);
+
+        xlnt::load_options options;
+        options.worksheet_threads = 8;
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+        xlnt::workbook wb;
+        wb.load(data_stream, options);
+
+        for (auto ws : wb)
+        {
+            xlnt_assert_equals(ws.merged_ranges().size(), 2000);
+            xlnt_assert_equals(ws.cell("A2000").value<std::string>(), "left 2000");
+            xlnt_assert(ws.cell("B2000").is_merged());
+            xlnt_assert_equals(ws.cell("B2000").value<std::string>(), "");
+        }
+
+        std::vector<std::uint8_t> destination;
+        wb.save(destination);
+        xlnt_assert(xml_helper::xlsx_archives_match(data, destination));
+    }
+
+    void test_load_lazy_worksheets()
+    {
+        xlnt::load_options options;
+        options.lazy_worksheets = true;
+
+        // every part must come out the same as it would from an eager load
+        const auto path = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+        std::ifstream source_stream(path.string(), std::ios::binary);
+        const auto source = xlnt::detail::to_vector(source_stream);
+
+        xlnt::workbook from_file;
+        from_file.load(path, options);
+        std::vector<std::uint8_t> destination;
+        from_file.save(destination);
+        xlnt_assert(xml_helper::xlsx_archives_match(source, destination));
+
+        xlnt::detail::vector_istreambuf source_buffer(source);
+        std::istream source_data(&source_buffer);
+        xlnt::workbook from_stream;
+        from_stream.load(source_data, options);
+        destination.clear();
+        from_stream.save(destination);
+        xlnt_assert(xml_helper::xlsx_archives_match(source, destination));
+
+        xlnt::workbook wb;
+        wb.active_sheet().title("first");
+        wb.active_sheet().cell("A1").value(1);
+        wb.create_sheet().title("second");
+        wb.sheet_by_title("second").cell("B2").value("two");
+        wb.create_sheet().title("third");
+        wb.sheet_by_title("third").cell("C3").value(3.5);
+        wb.sheet_by_title("third").cell("C3").number_format(xlnt::number_format::percentage());
+
+        temporary_file file;
+        wb.save(file.get_path());
+
+        {
+            xlnt::workbook wb2;
+            wb2.load(file.get_path(), options);
+
+            // the mapped file is kept open by the workbook
+            std::remove(file.get_path().string().c_str());
+
+            xlnt_assert_equals(wb2.sheet_titles(), std::vector<std::string>({"first", "second", "third"}));
+            xlnt_assert_equals(wb2.sheet_by_title("second").cell("B2").value<std::string>(), "two");
+
+            // deferred worksheets are read into wherever the workbook has moved
+            auto wb3 = std::move(wb2);
+            xlnt_assert_equals(wb3.sheet_by_index(2).cell("C3").value<double>(), 3.5);
+            xlnt_assert_equals(wb3.sheet_by_index(2).cell("C3").number_format(), xlnt::number_format::percentage());
+
+            std::vector<std::string> dimensions;
+
+            for (auto ws : wb3)
+            {
+                dimensions.push_back(ws.calculate_dimension().to_string());
+            }
+
+            xlnt_assert_equals(dimensions, std::vector<std::string>({"A1:A1", "B2:B2", "C3:C3"}));
+
+            const auto copy = wb3;
+            xlnt_assert_equals(copy.sheet_by_index(0).cell("A1").value<int>(), 1);
+        }
+    }
+
+    void test_remove_lazy_worksheet()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().title("first");
+        wb.active_sheet().cell("A1").value(1);
+        wb.create_sheet().title("second");
+        wb.sheet_by_title("second").cell("B2").value("two");
+        wb.create_sheet().title("third");
+        wb.sheet_by_title("third").cell("C3").value(3.5);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::load_options options;
+        options.lazy_worksheets = true;
+
+        const auto titles = std::vector<std::string>{"first", "second", "third"};
+        const auto references = std::vector<std::string>{"A1", "B2", "C3"};
+
+        // removing a sheet renumbers the relationships of the unread ones
+        for (std::size_t removed = 0; removed < titles.size(); ++removed)
+        {
+            xlnt::detail::vector_istreambuf data_buffer(data);
+            std::istream data_stream(&data_buffer);
+            xlnt::workbook lazy;
+            lazy.load(data_stream, options);
+            lazy.remove_sheet(lazy.sheet_by_index(removed));
+
+            std::vector<std::uint8_t> saved;
+            lazy.save(saved);
+
+            xlnt::workbook reloaded;
+            reloaded.load(saved);
+
+            for (auto loaded : {&lazy, &reloaded})
+            {
+                xlnt_assert_equals(loaded->sheet_count(), 2);
+
+                for (std::size_t i = 0; i < titles.size(); ++i)
+                {
+                    if (i == removed) continue;
+
+                    const auto ws = loaded->sheet_by_title(titles[i]);
+                    xlnt_assert_equals(ws.calculate_dimension().to_string(), references[i] + ":" + references[i]);
+                }
+            }
+        }
+    }
+
+    void test_save_compression_threads()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // enough cells for the worksheet part to span several compressed blocks
+        for (xlnt::row_t row = 1; row <= 20000; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 5; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * column));
+            }
+        }
+
+        xlnt::save_options options;
+        options.compression_threads = 4;
+
+        std::vector<std::uint8_t> serial_data;
+        wb.save(serial_data);
+
+        std::vector<std::uint8_t> concurrent_data;
+        {
+            xlnt::detail::vector_ostreambuf concurrent_buffer(concurrent_data);
+            std::ostream concurrent_stream(&concurrent_buffer);
+            wb.save(concurrent_stream, options);
+        }
+
+        xlnt_assert(xml_helper::xlsx_archives_match(serial_data, concurrent_data));
+
+        xlnt::workbook wb2;
+        wb2.load(concurrent_data);
+        xlnt_assert_equals(wb2.active_sheet().cell("E20000").value<int>(), 100000);
+    }
+
+    std::vector<std::uint8_t> save_with_options(const xlnt::workbook &wb, const xlnt::save_options &options)
+    {
+        std::vector<std::uint8_t> data;
+        xlnt::detail::vector_ostreambuf data_buffer(data);
+        std::ostream data_stream(&data_buffer);
+        wb.save(data_stream, options);
+
+        return data;
+    }
+
+    void test_save_compression_levels()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 2000; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+            ws.cell(2, row).value("row " + std::to_string(row % 10));
+        }
+
+        std::vector<std::uint8_t> default_data;
+        wb.save(default_data);
+
+        xlnt::save_options stored_options;
+        stored_options.compression_level = 0;
+        const auto stored_data = save_with_options(wb, stored_options);
+
+        xlnt::save_options stored_worksheet_options;
+        stored_worksheet_options.part_compression_levels[xlnt::relationship_type::worksheet] = 0;
+        const auto stored_worksheet_data = save_with_options(wb, stored_worksheet_options);
+
+        xlnt::save_options smallest_options;
+        smallest_options.compression_level = 9;
+        const auto smallest_data = save_with_options(wb, smallest_options);
+
+        xlnt::save_options huffman_options;
+        huffman_options.compression_level = 1;
+        huffman_options.strategy = xlnt::compression_strategy::huffman_only;
+        const auto huffman_data = save_with_options(wb, huffman_options);
+
+        xlnt_assert(stored_data.size() > stored_worksheet_data.size());
+        xlnt_assert(stored_worksheet_data.size() > default_data.size());
+        xlnt_assert(smallest_data.size() <= default_data.size());
+        xlnt_assert(huffman_data.size() > default_data.size());
+
+        for (const auto &data : {stored_data, stored_worksheet_data, smallest_data, huffman_data})
+        {
+            xlnt_assert(xml_helper::xlsx_archives_match(default_data, data));
+        }
+
+        xlnt::workbook wb2;
+        wb2.load(stored_data);
+        xlnt_assert_equals(wb2.active_sheet().cell("A2000").value<int>(), 2000);
+
+        xlnt::save_options invalid_options;
+        invalid_options.compression_level = 10;
+        xlnt_assert_throws(save_with_options(wb, invalid_options), xlnt::invalid_parameter);
+    }
+
     void test_round_trip_rw_encrypted()
     {
         const auto files = std::vector<std::string>
@@ -461,4 +756,284 @@ public:
             xlnt_assert(round_trip_matches_rw(path, password));
         }
     }
+
+    // Saves wb and replaces its first worksheet part with the result of rewrite,
+    // as if the part had been written by another application.
+    std::vector<std::uint8_t> save_with_rewritten_worksheet(const xlnt::workbook &wb,
+        const std::function<std::string(const std::string &)> &rewrite)
+    {
+        std::vector<std::uint8_t> source_data;
+        wb.save(source_data);
+
+        std::vector<std::uint8_t> destination_data;
+        xlnt::detail::vector_istreambuf source_buffer(source_data);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream source_archive(source_stream);
+
+        xlnt::detail::vector_ostreambuf destination_buffer(destination_data);
+        std::ostream destination_stream(&destination_buffer);
+
+        {
+            xlnt::detail::ozstream destination_archive(destination_stream);
+            const auto sheet_path = xlnt::path("xl/worksheets/sheet1.xml");
+
+            for (const auto &file : source_archive.files())
+            {
+                auto content = source_archive.read(file);
+
+                if (file == sheet_path)
+                {
+                    content = rewrite(content);
+                }
+
+                auto file_buffer = destination_archive.open(file);
+                std::ostream(file_buffer.get()) << content;
+            }
+        }
+
+        return destination_data;
+    }
+
+    void test_read_cells_without_references()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("B1").value(2);
+        ws.cell("C1").value(3);
+        ws.cell("A2").value(4);
+        ws.cell("C2").value(5);
+
+        // remove all row and cell references except C2, which can't be inferred from its position
+        const auto destination_data = save_with_rewritten_worksheet(wb, [](const std::string &content) {
+            auto rewritten = std::regex_replace(content, std::regex(" r=\"(?!C2\")[A-Z]*[0-9]+\""), "");
+            xlnt_assert_equals(rewritten.find(" r=\"A1\""), std::string::npos);
+
+            return rewritten;
+        });
+
+        xlnt::workbook wb2;
+        wb2.load(destination_data);
+        auto ws2 = wb2.active_sheet();
+
+        xlnt_assert_equals(ws2.cell("A1").value<int>(), 1);
+        xlnt_assert_equals(ws2.cell("B1").value<int>(), 2);
+        xlnt_assert_equals(ws2.cell("C1").value<int>(), 3);
+        xlnt_assert_equals(ws2.cell("A2").value<int>(), 4);
+        xlnt_assert(!ws2.has_cell("B2"));
+        xlnt_assert_equals(ws2.cell("C2").value<int>(), 5);
+        xlnt_assert(ws2.calculate_dimension() == xlnt::range_reference("A1:C2"));
+    }
+
+    void test_read_sheet_data_markup()
+    {
+        // the same rows written in ways that the worksheet tokenizer handles and,
+        // with a comment, in a way that makes the whole part go through xml::parser
+        const auto rows = std::string(
+            "<row r='1' spans=\"1:4\" ht=\" 20.5 \" customHeight=\"1\">\r\n"
+            "  <c r=\"A1\"><v> 1.5 </v></c>\n"
+            "  <c r=\"B1\" t=\"inlineStr\"><is><t xml:space=\"preserve\">a &lt;b&gt; &amp; &#x263A;&#65;\r\nz</t></is></c>\n"
+            "  <c r = \"C1\" ><f>SUM(A1:A2)</f><v>3.5</v></c>\n"
+            "  <c r=\"D1\" t=\"b\"><v>1</v></c>\n"
+            "  <c r=\"E1\" t=\"str\"><v/></c>\n"
+            "  <c r=\"F1\" t=\"s\"><v>\n0\n</v></c>\n"
+            "  <c r=\"G1\"><v>\t-7\r\n</v></c>\n"
+            "</row>\n"
+            "<row><c><v>2</v></c><c t=\"e\"><v>#N/A</v></c></row>"
+            "<row r=\"5\" hidden=\"1\"/>");
+
+        for (const auto &separator : {std::string("\n"), std::string("<!-- </sheetData> -->")})
+        {
+            xlnt::workbook wb;
+            wb.active_sheet().cell("A1").value(1);
+            wb.active_sheet().cell("B1").value("shared");
+
+            const auto data = save_with_rewritten_worksheet(wb, [&](const std::string &content) {
+                const auto sheet_data = "<sheetData>" + separator + rows + separator + "</sheetData>";
+                return std::regex_replace(content, std::regex("<sheetData>[\\s\\S]*</sheetData>"), sheet_data);
+            });
+
+            xlnt::workbook wb2;
+            wb2.load(data);
+            auto ws2 = wb2.active_sheet();
+
+            xlnt_assert_equals(ws2.cell("A1").value<double>(), 1.5);
+            xlnt_assert_equals(ws2.cell("B1").data_type(), xlnt::cell::type::inline_string);
+            xlnt_assert_equals(ws2.cell("B1").value<std::string>(), "a <b> & \xE2\x98\xBA" "A\nz");
+            xlnt_assert_equals(ws2.cell("C1").formula(), "SUM(A1:A2)");
+            xlnt_assert_equals(ws2.cell("C1").value<double>(), 3.5);
+            xlnt_assert(ws2.cell("D1").value<bool>());
+            xlnt_assert_equals(ws2.cell("E1").data_type(), xlnt::cell::type::formula_string);
+            xlnt_assert_equals(ws2.cell("F1").value<std::string>(), "shared");
+            xlnt_assert_equals(ws2.cell("G1").value<int>(), -7);
+            xlnt_assert_equals(ws2.cell("A2").value<int>(), 2);
+            xlnt_assert_equals(ws2.cell("B2").data_type(), xlnt::cell::type::error);
+            xlnt_assert_equals(ws2.row_properties(1).height.get(), 20.5);
+            xlnt_assert(ws2.row_properties(1).custom_height);
+            xlnt_assert(ws2.row_properties(5).hidden);
+            xlnt_assert(ws2.calculate_dimension() == xlnt::range_reference("A1:G2"));
+        }
+    }
+
+    void test_read_numbers()
+    {
+        const auto written = std::vector<std::pair<std::string, long double>>
+        {
+            {"0", 0.0L},
+            {"-42", -42.0L},
+            {"+7", 7.0L},
+            {"0.5", 0.5L},
+            {".25", 0.25L},
+            {"-1234.5678", -1234.5678L},
+            {"1.5E-3", 1.5E-3L},
+            {"2e10", 2e10L},
+            {"0.1000000000000000055511151231257827", 0.1000000000000000055511151231257827L},
+            {"12345678901234567890123", 12345678901234567890123.0L},
+            {"1.7976931348623157E+308", 1.7976931348623157E+308L},
+            {"4.9406564584124654E-324", 4.9406564584124654E-324L}
+        };
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (std::size_t i = 0; i < written.size(); ++i)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(i + 1)).value(static_cast<int>(i + 1000));
+        }
+
+        // replace each placeholder with the text of the number to read
+        const auto data = save_with_rewritten_worksheet(wb, [&written](const std::string &content) {
+            auto rewritten = content;
+
+            for (std::size_t i = 0; i < written.size(); ++i)
+            {
+                const auto placeholder = "<v>" + std::to_string(i + 1000) + "</v>";
+                rewritten.replace(rewritten.find(placeholder), placeholder.size(), "<v>" + written[i].first + "</v>");
+            }
+
+            return rewritten;
+        });
+
+        xlnt::workbook wb2;
+        wb2.load(data);
+        auto ws2 = wb2.active_sheet();
+
+        for (std::size_t i = 0; i < written.size(); ++i)
+        {
+            const auto cell = ws2.cell(1, static_cast<xlnt::row_t>(i + 1));
+            xlnt_assert_equals(cell.data_type(), xlnt::cell::type::number);
+            xlnt_assert_equals(cell.value<long double>(), written[i].second);
+        }
+
+        const auto invalid = save_with_rewritten_worksheet(wb, [](const std::string &content) {
+            auto rewritten = content;
+            rewritten.replace(rewritten.find("<v>1000</v>"), 11, "<v>1.5.3</v>");
+
+            return rewritten;
+        });
+
+        xlnt::workbook wb3;
+        xlnt_assert_throws(wb3.load(invalid), xlnt::invalid_file);
+    }
+
+    void test_write_sparse_worksheet()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("C5").value(1);
+        ws.cell("XFD1048576").value(2);
+        ws.cell("B1048576").value(3);
+        ws.cell("A7"); // garbage collectible so it isn't written
+
+        xlnt_assert(ws.calculate_dimension() == xlnt::range_reference("A5:XFD1048576"));
+
+        // only the three cells are visited rather than every cell in the dimension
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+        xlnt::detail::izstream archive(data_stream);
+        const auto sheet = archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+
+        xlnt_assert_differs(sheet.find("<dimension ref=\"A5:XFD1048576\"/>"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"5\" spans=\"3:3\">"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"1048576\" spans=\"2:16384\">"), std::string::npos);
+        xlnt_assert_equals(sheet.find("<row r=\"7\""), std::string::npos);
+
+        ws.garbage_collect();
+        xlnt_assert(ws.calculate_dimension() == xlnt::range_reference("B5:XFD1048576"));
+
+        xlnt::workbook wb2;
+        wb2.load(data);
+        xlnt_assert_equals(wb2.active_sheet().cell("XFD1048576").value<int>(), 2);
+        xlnt_assert_equals(wb2.active_sheet().cell("B1048576").value<int>(), 3);
+    }
+
+    void test_write_shortest_numbers()
+    {
+        const auto expected = std::vector<std::pair<double, std::string>>
+        {
+            {42, "42"},
+            {-0.5, "-0.5"},
+            {0.1, "0.1"},
+            {0.1 + 0.2, "0.30000000000000004"},
+            {123.456, "123.456"},
+            {0.00001, "0.00001"},
+            {1.5e-7, "1.5E-7"},
+            {9007199254740992.0, "9007199254740992"},
+            {1e20, "1E+20"},
+            {-1.7976931348623157e308, "-1.7976931348623157E+308"}
+        };
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(i + 1)).value(expected[i].first);
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+        xlnt::detail::izstream archive(data_stream);
+        const auto sheet = archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+
+        xlnt::workbook wb2;
+        wb2.load(data);
+        auto ws2 = wb2.active_sheet();
+
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            xlnt_assert_differs(sheet.find("<v>" + expected[i].second + "</v>"), std::string::npos);
+            xlnt_assert_equals(ws2.cell(1, static_cast<xlnt::row_t>(i + 1)).value<double>(), expected[i].first);
+        }
+    }
+
+    void test_write_escaped_cell_text()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").formula("IF(B1<2,\"x&y\",\">\r\n\")");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+        xlnt::detail::izstream archive(data_stream);
+        const auto sheet = archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+
+        xlnt_assert_differs(sheet.find("<f>IF(B1&lt;2,\"x&amp;y\",\"&gt;&#xD;\n\")</f>"), std::string::npos);
+
+        xlnt::workbook wb2;
+        wb2.load(data);
+        xlnt_assert_equals(wb2.active_sheet().cell("A1").formula(), "IF(B1<2,\"x&y\",\">\r\n\")");
+
+        ws.cell("A2").formula("CHAR(1)=\"\x01\"");
+        xlnt_assert_throws(wb.save(data), xlnt::exception);
+    }
 };
@@ -0,0 +1,348 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <iostream>
+
+#include <detail/serialization/vector_streambuf.hpp>
+#include <helpers/path_helper.hpp>
+#include <helpers/test_suite.hpp>
+#include <xlnt/styles/font.hpp>
+#include <xlnt/styles/format.hpp>
+#include <xlnt/workbook/streaming_reader.hpp>
+#include <xlnt/workbook/streaming_writer.hpp>
+#include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/worksheet.hpp>
+
+class streaming_test_suite : public test_suite
+{
+public:
+    streaming_test_suite()
+    {
+        register_test(test_read_sheet_titles);
+        register_test(test_read_rows);
+        register_test(test_read_empty_worksheet);
+        register_test(test_read_unknown_worksheet);
+        register_test(test_write_rows);
+        register_test(test_write_multiple_worksheets);
+        register_test(test_write_rows_out_of_order);
+        register_test(test_write_cells_out_of_order);
+        register_test(test_write_formats_survive_compaction);
+    }
+
+    xlnt::streamed_cell make_cell(const std::string &reference, xlnt::cell_type type)
+    {
+        xlnt::streamed_cell cell;
+        cell.reference = xlnt::cell_reference(reference);
+        cell.type = type;
+
+        return cell;
+    }
+
+    void test_read_sheet_titles()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().title("First");
+        wb.create_sheet().title("Second");
+        wb.create_sheet().title("Third");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+
+        xlnt::streaming_reader reader;
+        reader.open(data_stream);
+
+        const auto expected = std::vector<std::string>{"First", "Second", "Third"};
+        xlnt_assert_equals(reader.sheet_titles(), expected);
+    }
+
+    void test_read_rows()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("Data");
+        wb.create_sheet().cell("A1").value("other sheet");
+
+        ws.cell("A1").value("text");
+        ws.cell("B1").value(1.5);
+        ws.cell("D1").value(true);
+        ws.cell("B3").value(42);
+        ws.cell("B3").font(xlnt::font().bold(true));
+        ws.cell("C3").formula("=B3*2");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+
+        xlnt::streaming_reader reader;
+        reader.open(data_stream);
+        reader.begin_worksheet("Data");
+
+        xlnt_assert(reader.has_row());
+        const auto &first = reader.read_row();
+        xlnt_assert_equals(first.index, 1);
+        xlnt_assert_equals(first.cells.size(), 3);
+        xlnt_assert_equals(first.cells[0].reference, xlnt::cell_reference("A1"));
+        xlnt_assert_equals(first.cells[0].type, xlnt::cell_type::shared_string);
+        xlnt_assert_equals(first.cells[0].text, "text");
+        xlnt_assert_equals(first.cells[1].reference, xlnt::cell_reference("B1"));
+        xlnt_assert_equals(first.cells[1].type, xlnt::cell_type::number);
+        xlnt_assert_equals(first.cells[1].number, 1.5L);
+        xlnt_assert_equals(first.cells[2].reference, xlnt::cell_reference("D1"));
+        xlnt_assert_equals(first.cells[2].type, xlnt::cell_type::boolean);
+        xlnt_assert_equals(first.cells[2].number, 1);
+
+        xlnt_assert(reader.has_row());
+        const auto &third = reader.read_row();
+        xlnt_assert_equals(third.index, 3);
+        xlnt_assert_equals(third.cells.size(), 2);
+        xlnt_assert_equals(third.cells[0].type, xlnt::cell_type::number);
+        xlnt_assert_equals(third.cells[0].number, 42);
+        xlnt_assert(third.cells[0].format_id.is_set());
+        xlnt_assert(reader.workbook().format(third.cells[0].format_id.get()).font().bold());
+        xlnt_assert(third.cells[1].formula.is_set());
+        xlnt_assert_equals(third.cells[1].formula.get(), "B3*2");
+
+        xlnt_assert(!reader.has_row());
+        reader.end_worksheet();
+        xlnt_assert(!reader.has_row());
+    }
+
+    void test_read_empty_worksheet()
+    {
+        xlnt::streaming_reader reader;
+        reader.open(path_helper::test_file("3_default.xlsx"));
+        reader.begin_worksheet("Sheet1");
+        xlnt_assert(!reader.has_row());
+        reader.close();
+        xlnt_assert_throws(reader.sheet_titles(), xlnt::exception);
+    }
+
+    void test_read_unknown_worksheet()
+    {
+        xlnt::streaming_reader reader;
+        reader.open(path_helper::test_file("3_default.xlsx"));
+        xlnt_assert_throws(reader.begin_worksheet("Missing"), xlnt::key_not_found);
+    }
+
+    void test_write_rows()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf data_buffer(data);
+            std::ostream data_stream(&data_buffer);
+
+            xlnt::streaming_writer writer;
+            writer.open(data_stream);
+            const auto bold = writer.workbook().create_format().font(xlnt::font().bold(true), true);
+            writer.begin_worksheet("Report");
+
+            xlnt::streamed_row row;
+            row.cells.push_back(make_cell("A1", xlnt::cell_type::shared_string));
+            row.cells.back().text = "Name";
+            row.cells.back().format_id = bold.id();
+            row.cells.push_back(make_cell("C1", xlnt::cell_type::inline_string));
+            row.cells.back().text = "inline";
+            writer.append_row(row);
+
+            for (auto i = 0; i < 3; ++i)
+            {
+                row.cells.clear();
+                row.cells.push_back(make_cell("A1", xlnt::cell_type::shared_string));
+                row.cells.back().text = "Name";
+                row.cells.push_back(make_cell("B1", xlnt::cell_type::number));
+                row.cells.back().number = i + 0.5L;
+                row.cells.push_back(make_cell("C1", xlnt::cell_type::boolean));
+                row.cells.back().number = i % 2;
+                writer.append_row(row);
+            }
+
+            row.index = 10;
+            row.cells.clear();
+            row.cells.push_back(make_cell("B1", xlnt::cell_type::number));
+            row.cells.back().formula = "SUM(B2:B4)";
+            writer.append_row(row);
+
+            writer.close();
+        }
+
+        xlnt::workbook wb;
+        wb.load(data);
+        auto ws = wb.sheet_by_title("Report");
+
+        xlnt_assert_equals(wb.sheet_count(), 1);
+        xlnt_assert_equals(wb.shared_strings().size(), 1);
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "Name");
+        xlnt_assert(ws.cell("A1").font().bold());
+        xlnt_assert_equals(ws.cell("C1").value<std::string>(), "inline");
+        xlnt_assert_equals(ws.cell("A4").value<std::string>(), "Name");
+        xlnt_assert_equals(ws.cell("B3").value<double>(), 1.5);
+        xlnt_assert_equals(ws.cell("C3").value<bool>(), true);
+        xlnt_assert_equals(ws.cell("C4").value<bool>(), false);
+        xlnt_assert(ws.cell("B10").has_formula());
+        xlnt_assert_equals(ws.cell("B10").formula(), "SUM(B2:B4)");
+    }
+
+    void test_write_multiple_worksheets()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf data_buffer(data);
+            std::ostream data_stream(&data_buffer);
+
+            xlnt::streaming_writer writer;
+            writer.open(data_stream);
+
+            for (const auto &title : {"First", "Second", "Third"})
+            {
+                writer.begin_worksheet(title);
+
+                xlnt::streamed_row row;
+                row.cells.push_back(make_cell("A1", xlnt::cell_type::inline_string));
+                row.cells.back().text = title;
+                writer.append_row(row);
+            }
+
+            writer.close();
+        }
+
+        xlnt::detail::vector_istreambuf data_buffer(data);
+        std::istream data_stream(&data_buffer);
+
+        xlnt::streaming_reader reader;
+        reader.open(data_stream);
+
+        const auto expected = std::vector<std::string>{"First", "Second", "Third"};
+        xlnt_assert_equals(reader.sheet_titles(), expected);
+
+        for (const auto &title : expected)
+        {
+            reader.begin_worksheet(title);
+            xlnt_assert(reader.has_row());
+            const auto &row = reader.read_row();
+            xlnt_assert_equals(row.index, 1);
+            xlnt_assert_equals(row.cells.size(), 1);
+            xlnt_assert_equals(row.cells.front().text, title);
+            xlnt_assert(!reader.has_row());
+        }
+    }
+
+    void test_write_rows_out_of_order()
+    {
+        std::vector<std::uint8_t> data;
+        xlnt::detail::vector_ostreambuf data_buffer(data);
+        std::ostream data_stream(&data_buffer);
+
+        xlnt::streaming_writer writer;
+        writer.open(data_stream);
+        writer.begin_worksheet("Sheet");
+
+        xlnt::streamed_row row;
+        row.index = 5;
+        writer.append_row(row);
+
+        row.index = 2;
+        xlnt_assert_throws(writer.append_row(row), xlnt::invalid_parameter);
+
+        row.index = 5;
+        xlnt_assert_throws(writer.append_row(row), xlnt::invalid_parameter);
+        xlnt_assert_throws(writer.begin_worksheet("Sheet"), xlnt::invalid_sheet_title);
+    }
+
+    void test_write_cells_out_of_order()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf data_buffer(data);
+            std::ostream data_stream(&data_buffer);
+
+            xlnt::streaming_writer writer;
+            writer.open(data_stream);
+            writer.begin_worksheet("Sheet");
+
+            xlnt::streamed_row row;
+            row.cells.push_back(make_cell("B1", xlnt::cell_type::number));
+            row.cells.push_back(make_cell("A1", xlnt::cell_type::number));
+            xlnt_assert_throws(writer.append_row(row), xlnt::invalid_parameter);
+
+            row.cells.front().reference = xlnt::cell_reference("A1");
+            xlnt_assert_throws(writer.append_row(row), xlnt::invalid_parameter);
+
+            // a rejected row leaves nothing behind
+            row.cells.back().reference = xlnt::cell_reference("C1");
+            row.cells.back().number = 3;
+            writer.append_row(row);
+
+            writer.close();
+        }
+
+        xlnt::workbook wb;
+        wb.load(data);
+        auto ws = wb.active_sheet();
+
+        xlnt_assert_equals(ws.cell("C1").value<int>(), 3);
+        xlnt_assert(ws.calculate_dimension() == xlnt::range_reference("A1:C1"));
+    }
+
+    void test_write_formats_survive_compaction()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf data_buffer(data);
+            std::ostream data_stream(&data_buffer);
+
+            xlnt::streaming_writer writer;
+            writer.open(data_stream);
+            writer.workbook().create_format().font(xlnt::font().italic(true), true);
+            const auto bold = writer.workbook().create_format().font(xlnt::font().bold(true), true);
+            writer.begin_worksheet("Sheet");
+
+            xlnt::streamed_row row;
+            row.cells.push_back(make_cell("A1", xlnt::cell_type::number));
+            row.cells.back().format_id = bold.id() + 100;
+            xlnt_assert_throws(writer.append_row(row), xlnt::invalid_parameter);
+
+            row.cells.back().format_id = bold.id();
+            writer.append_row(row);
+
+            // the unused italic format comes before bold, so removing it would renumber bold
+            writer.workbook().compact_styles();
+            writer.close();
+        }
+
+        xlnt::workbook wb;
+        wb.load(data);
+
+        xlnt_assert(wb.active_sheet().cell("A1").font().bold());
+    }
+};
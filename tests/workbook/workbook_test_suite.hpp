@@ -25,6 +25,8 @@
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
@@ -56,6 +58,9 @@ public:
         register_test(test_memory);
         register_test(test_clear);
         register_test(test_comparison);
+        register_test(test_compact_styles);
+        register_test(test_compact_styles_after_sheet_copy);
+        register_test(test_shared_strings_edited_in_place);
     }
 
     void test_active_sheet()
@@ -327,4 +332,112 @@ public:
         wb.style("style1");
         wb_const.style("style1");
     }
+
+    void test_compact_styles()
+    {
+        auto format_count = [](const xlnt::workbook &wb) {
+            std::size_t count = 0;
+            while (true)
+            {
+                try
+                {
+                    wb.format(count);
+                }
+                catch (const std::out_of_range &)
+                {
+                    return count;
+                }
+                ++count;
+            }
+        };
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto size = 1; size <= 50; ++size)
+        {
+            ws.cell("A1").font(xlnt::font().size(size));
+            ws.cell("B1").fill(xlnt::fill::solid(xlnt::color::red()));
+        }
+
+        const auto before = format_count(wb);
+        xlnt_assert(before > 2);
+
+        wb.compact_styles();
+
+        xlnt_assert(format_count(wb) < before);
+        xlnt_assert_equals(ws.cell("A1").font().size(), 50);
+        xlnt_assert_equals(ws.cell("B1").fill(), xlnt::fill::solid(xlnt::color::red()));
+        xlnt_assert(ws.cell("A1").format().id() < format_count(wb));
+        xlnt_assert(ws.cell("B1").format().id() < format_count(wb));
+
+        for (auto size = 1; size <= 10; ++size)
+        {
+            ws.cell("A1").font(xlnt::font().size(size));
+        }
+
+        xlnt::save_options options;
+        options.compact_styles = true;
+        std::ostringstream stream;
+        wb.save(stream, options);
+
+        xlnt::workbook loaded;
+        std::istringstream source(stream.str());
+        loaded.load(source);
+        xlnt_assert_equals(loaded.active_sheet().cell("A1").font().size(), 10);
+        xlnt_assert_equals(loaded.active_sheet().cell("B1").fill(), xlnt::fill::solid(xlnt::color::red()));
+    }
+
+    void test_compact_styles_after_sheet_copy()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").font(xlnt::font().bold(true));
+
+        auto copy = wb.copy_sheet(ws);
+        auto first = wb.copy_sheet(ws, 0);
+        ws.cell("A1").clear_format();
+        wb.compact_styles();
+
+        xlnt_assert(copy.cell("A1").font().bold());
+        xlnt_assert(first.cell("A1").font().bold());
+
+        // removed sheets no longer keep their formats
+        auto removed = wb.create_sheet();
+        removed.cell("A1").font(xlnt::font().size(33));
+        wb.remove_sheet(removed);
+        wb.remove_sheet(first);
+        wb.compact_styles();
+
+        xlnt_assert(copy.cell("A1").font().bold());
+
+        for (std::size_t id = 0; id < 10; ++id)
+        {
+            auto size = 0.0;
+
+            try
+            {
+                size = wb.format(id).font().size();
+            }
+            catch (const std::out_of_range &)
+            {
+                break;
+            }
+
+            xlnt_assert_differs(size, 33);
+        }
+    }
+
+    void test_shared_strings_edited_in_place()
+    {
+        xlnt::workbook wb;
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 1);
+
+        wb.shared_strings()[0] = xlnt::rich_text("c");
+
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("c")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 2);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 1);
+    }
 };
@@ -0,0 +1,273 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <detail/serialization/miniz.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
+#include <helpers/test_suite.hpp>
+#include <xlnt/utils/path.hpp>
+
+class zip_test_suite : public test_suite
+{
+public:
+    zip_test_suite()
+    {
+        register_test(test_small_archive_has_no_zip64_records);
+        register_test(test_write_more_than_65535_entries);
+        register_test(test_read_zip64_extra_fields);
+        register_test(test_read_from_memory);
+    }
+
+    template <typename T>
+    void append_int(std::vector<std::uint8_t> &bytes, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bytes.push_back(static_cast<std::uint8_t>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    bool contains_signature(const std::vector<std::uint8_t> &bytes, std::uint32_t signature)
+    {
+        std::vector<std::uint8_t> pattern;
+        append_int(pattern, signature);
+
+        return std::search(bytes.begin(), bytes.end(), pattern.begin(), pattern.end()) != bytes.end();
+    }
+
+    void write_archive(std::vector<std::uint8_t> &bytes, std::size_t file_count)
+    {
+        xlnt::detail::vector_ostreambuf archive_buffer(bytes);
+        std::ostream archive_stream(&archive_buffer);
+        xlnt::detail::ozstream archive(archive_stream);
+
+        for (std::size_t i = 0; i < file_count; ++i)
+        {
+            auto file_buffer = archive.open(xlnt::path(std::to_string(i)));
+            std::ostream file_stream(file_buffer.get());
+            file_stream << i;
+        }
+    }
+
+    void test_small_archive_has_no_zip64_records()
+    {
+        std::vector<std::uint8_t> bytes;
+        write_archive(bytes, 3);
+
+        xlnt_assert(!contains_signature(bytes, 0x06064b50));
+        xlnt_assert(!contains_signature(bytes, 0x07064b50));
+
+        // local headers reserve a ZIP64 extra field for sizes written afterwards,
+        // so they need version 4.5 while central headers without one stay at 2.0
+        const auto version_at = [&bytes](std::size_t offset) {
+            return static_cast<std::uint16_t>(bytes[offset] | (bytes[offset + 1] << 8));
+        };
+
+        xlnt_assert_equals(version_at(4), 45);
+        xlnt_assert_equals(version_at(28), 20); // extra field length
+
+        std::vector<std::uint8_t> central_signature;
+        append_int(central_signature, static_cast<std::uint32_t>(0x02014b50));
+        const auto central = static_cast<std::size_t>(
+            std::search(bytes.begin(), bytes.end(), central_signature.begin(), central_signature.end()) - bytes.begin());
+        xlnt_assert_equals(version_at(central + 6), 20);
+        xlnt_assert_equals(version_at(central + 30), 0); // extra field length
+
+        xlnt::detail::vector_istreambuf archive_buffer(bytes);
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream archive(archive_stream);
+
+        xlnt_assert_equals(archive.files().size(), 3);
+        xlnt_assert_equals(archive.read(xlnt::path("2")), "2");
+    }
+
+    void test_write_more_than_65535_entries()
+    {
+        const std::size_t file_count = 70000;
+
+        std::vector<std::uint8_t> bytes;
+        write_archive(bytes, file_count);
+
+        xlnt_assert(contains_signature(bytes, 0x06064b50));
+        xlnt_assert(contains_signature(bytes, 0x07064b50));
+
+        xlnt::detail::vector_istreambuf archive_buffer(bytes);
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream archive(archive_stream);
+
+        xlnt_assert_equals(archive.files().size(), file_count);
+        xlnt_assert_equals(archive.read(xlnt::path("0")), "0");
+        xlnt_assert_equals(archive.read(xlnt::path("65535")), "65535");
+        xlnt_assert_equals(archive.read(xlnt::path("69999")), "69999");
+    }
+
+    void test_read_zip64_extra_fields()
+    {
+        // A stored entry whose sizes and offset are only given in ZIP64 extra fields
+        // and whose entry count and directory offset are only given in the ZIP64
+        // end of central directory record, as written for archives over 4 GiB.
+        const std::string filename = "big.txt";
+        const std::string contents = "zip64";
+        const auto crc = static_cast<std::uint32_t>(
+            crc32(0, reinterpret_cast<const unsigned char *>(contents.data()), contents.size()));
+
+        std::vector<std::uint8_t> bytes;
+
+        append_int(bytes, std::uint32_t(0x04034b50)); // local header
+        append_int(bytes, std::uint16_t(45)); // version needed
+        append_int(bytes, std::uint16_t(0)); // flags
+        append_int(bytes, std::uint16_t(0)); // stored
+        append_int(bytes, std::uint16_t(0)); // time
+        append_int(bytes, std::uint16_t(0)); // date
+        append_int(bytes, crc);
+        append_int(bytes, std::uint32_t(0xffffffff)); // compressed size
+        append_int(bytes, std::uint32_t(0xffffffff)); // uncompressed size
+        append_int(bytes, static_cast<std::uint16_t>(filename.size()));
+        append_int(bytes, std::uint16_t(20)); // extra length
+        bytes.insert(bytes.end(), filename.begin(), filename.end());
+        append_int(bytes, std::uint16_t(0x0001)); // ZIP64 extra
+        append_int(bytes, std::uint16_t(16));
+        append_int(bytes, static_cast<std::uint64_t>(contents.size()));
+        append_int(bytes, static_cast<std::uint64_t>(contents.size()));
+        bytes.insert(bytes.end(), contents.begin(), contents.end());
+
+        const auto central_offset = static_cast<std::uint64_t>(bytes.size());
+
+        append_int(bytes, std::uint32_t(0x02014b50)); // central header
+        append_int(bytes, std::uint16_t(45)); // version made by
+        append_int(bytes, std::uint16_t(45)); // version needed
+        append_int(bytes, std::uint16_t(0)); // flags
+        append_int(bytes, std::uint16_t(0)); // stored
+        append_int(bytes, std::uint16_t(0)); // time
+        append_int(bytes, std::uint16_t(0)); // date
+        append_int(bytes, crc);
+        append_int(bytes, std::uint32_t(0xffffffff)); // compressed size
+        append_int(bytes, std::uint32_t(0xffffffff)); // uncompressed size
+        append_int(bytes, static_cast<std::uint16_t>(filename.size()));
+        append_int(bytes, std::uint16_t(28)); // extra length
+        append_int(bytes, std::uint16_t(0)); // comment length
+        append_int(bytes, std::uint16_t(0)); // disk number
+        append_int(bytes, std::uint16_t(0)); // internal attributes
+        append_int(bytes, std::uint32_t(0)); // external attributes
+        append_int(bytes, std::uint32_t(0xffffffff)); // local header offset
+        bytes.insert(bytes.end(), filename.begin(), filename.end());
+        append_int(bytes, std::uint16_t(0x0001)); // ZIP64 extra
+        append_int(bytes, std::uint16_t(24));
+        append_int(bytes, static_cast<std::uint64_t>(contents.size()));
+        append_int(bytes, static_cast<std::uint64_t>(contents.size()));
+        append_int(bytes, std::uint64_t(0));
+
+        const auto central_size = static_cast<std::uint64_t>(bytes.size()) - central_offset;
+        const auto zip64_end_offset = static_cast<std::uint64_t>(bytes.size());
+
+        append_int(bytes, std::uint32_t(0x06064b50)); // ZIP64 end of central directory
+        append_int(bytes, std::uint64_t(44));
+        append_int(bytes, std::uint16_t(45));
+        append_int(bytes, std::uint16_t(45));
+        append_int(bytes, std::uint32_t(0));
+        append_int(bytes, std::uint32_t(0));
+        append_int(bytes, std::uint64_t(1));
+        append_int(bytes, std::uint64_t(1));
+        append_int(bytes, central_size);
+        append_int(bytes, central_offset);
+
+        append_int(bytes, std::uint32_t(0x07064b50)); // ZIP64 end of central directory locator
+        append_int(bytes, std::uint32_t(0));
+        append_int(bytes, zip64_end_offset);
+        append_int(bytes, std::uint32_t(1));
+
+        append_int(bytes, std::uint32_t(0x06054b50)); // end of central directory
+        append_int(bytes, std::uint16_t(0));
+        append_int(bytes, std::uint16_t(0));
+        append_int(bytes, std::uint16_t(0xffff));
+        append_int(bytes, std::uint16_t(0xffff));
+        append_int(bytes, std::uint32_t(0xffffffff));
+        append_int(bytes, std::uint32_t(0xffffffff));
+        append_int(bytes, std::uint16_t(0));
+
+        xlnt::detail::vector_istreambuf archive_buffer(bytes);
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream archive(archive_stream);
+
+        xlnt_assert_equals(archive.files().size(), 1);
+        xlnt_assert_equals(archive.read(xlnt::path(filename)), contents);
+
+        auto detached_buffer = archive.open_detached(xlnt::path(filename));
+        std::istream detached_stream(detached_buffer.get());
+        xlnt_assert_equals(std::string(std::istreambuf_iterator<char>(detached_stream), {}), contents);
+
+        xlnt::detail::izstream memory_archive(bytes.data(), bytes.size());
+        xlnt_assert_equals(memory_archive.read(xlnt::path(filename)), contents);
+    }
+
+    void test_read_from_memory()
+    {
+        std::vector<std::uint8_t> bytes;
+
+        {
+            xlnt::detail::vector_ostreambuf archive_buffer(bytes);
+            std::ostream archive_stream(&archive_buffer);
+            xlnt::detail::ozstream archive(archive_stream);
+
+            auto small_buffer = archive.open(xlnt::path("small"));
+            std::ostream small_stream(small_buffer.get());
+            small_stream << "small";
+            small_stream.flush();
+            small_buffer.reset();
+
+            // larger than the buffer that is inflated into at a time
+            auto large_buffer = archive.open(xlnt::path("large"));
+            std::ostream large_stream(large_buffer.get());
+
+            for (auto i = 0; i < 100000; ++i)
+            {
+                large_stream << i << '\n';
+            }
+        }
+
+        xlnt::detail::vector_istreambuf archive_buffer(bytes);
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream stream_archive(archive_stream);
+        xlnt::detail::izstream memory_archive(bytes.data(), bytes.size());
+
+        xlnt_assert_equals(memory_archive.files().size(), 2);
+        xlnt_assert_equals(memory_archive.read(xlnt::path("small")), "small");
+        xlnt_assert_equals(memory_archive.read(xlnt::path("large")), stream_archive.read(xlnt::path("large")));
+
+        auto detached_buffer = memory_archive.open_detached(xlnt::path("large"));
+        std::istream detached_stream(detached_buffer.get());
+        std::string line;
+        std::getline(detached_stream, line);
+        xlnt_assert_equals(line, "0");
+        detached_stream.unget();
+        xlnt_assert_equals(detached_stream.get(), '\n');
+    }
+};
@@ -36,6 +36,9 @@ public:
     range_test_suite()
     {
         register_test(test_batch_formatting);
+        register_test(test_batch_formatting_keeps_other_attributes);
+        register_test(test_batch_formatting_skips_null_cells);
+        register_test(test_worksheet_format_range);
     }
 
     void test_batch_formatting()
@@ -66,4 +69,72 @@ public:
 
         xlnt_assert(!ws.cell("B2").has_format());
     }
+
+    void test_batch_formatting_keeps_other_attributes()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").fill(xlnt::fill::solid(xlnt::color::red()));
+        ws.cell("A2").fill(xlnt::fill::solid(xlnt::color::red()));
+        ws.cell("A3").fill(xlnt::fill::solid(xlnt::color::blue()));
+
+        ws.range("A1:B3").font(xlnt::font().bold(true));
+
+        for (auto row = 1; row <= 3; ++row)
+        {
+            xlnt_assert(ws.cell(1, row).font().bold());
+            xlnt_assert(ws.cell(2, row).font().bold());
+            xlnt_assert(!ws.cell(2, row).format().fill_applied());
+        }
+
+        xlnt_assert_equals(ws.cell("A1").fill(), xlnt::fill::solid(xlnt::color::red()));
+        xlnt_assert_equals(ws.cell("A3").fill(), xlnt::fill::solid(xlnt::color::blue()));
+        xlnt_assert_equals(ws.cell("A1").format().id(), ws.cell("A2").format().id());
+        xlnt_assert_equals(ws.cell("B1").format().id(), ws.cell("B3").format().id());
+        xlnt_assert_differs(ws.cell("A1").format().id(), ws.cell("A3").format().id());
+
+        wb.compact_styles();
+
+        xlnt_assert(ws.cell("A1").font().bold());
+        xlnt_assert_equals(ws.cell("A3").fill(), xlnt::fill::solid(xlnt::color::blue()));
+        xlnt_assert(ws.cell("B2").font().bold());
+    }
+
+    void test_batch_formatting_skips_null_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("A1").value(1);
+        ws.cell("C3").value(2);
+
+        ws.rows().font(xlnt::font().italic(true));
+
+        xlnt_assert(ws.cell("A1").font().italic());
+        xlnt_assert(ws.cell("C3").font().italic());
+        xlnt_assert(!ws.has_cell("B2"));
+    }
+
+    void test_worksheet_format_range()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("B2").font(xlnt::font().size(20));
+        auto format = wb.create_format().number_format(xlnt::number_format::percentage(), true);
+
+        ws.format(xlnt::range_reference("A1:C3"), format);
+
+        for (auto row = 1; row <= 3; ++row)
+        {
+            for (auto column = 1; column <= 3; ++column)
+            {
+                xlnt_assert_equals(ws.cell(column, row).format().id(), format.id());
+            }
+        }
+
+        xlnt_assert_equals(ws.cell("B2").number_format(), xlnt::number_format::percentage());
+        xlnt_assert(!ws.has_cell("D4"));
+    }
 };
@@ -93,6 +93,7 @@ public:
         register_test(test_get_point_pos);
         register_test(test_named_range_named_cell_reference);
         register_test(test_iteration_skip_empty);
+        register_test(test_cell_access_order);
     }
 
     void test_new_worksheet()
@@ -1088,4 +1089,35 @@ public:
             xlnt_assert_equals(cells[1].value<std::string>(), "F6");
         }
     }
+
+    void test_cell_access_order()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // every other row first so that later rows are inserted between existing ones
+        for (xlnt::row_t row = 2; row <= 20; row += 2)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+        }
+
+        for (xlnt::row_t row = 1; row <= 20; ++row)
+        {
+            ws.cell(2, row).value(static_cast<int>(row) * 10);
+        }
+
+        for (xlnt::row_t row = 20; row >= 1; --row)
+        {
+            ws.cell(3, row).value(static_cast<int>(row) * 100);
+        }
+
+        for (xlnt::row_t row = 1; row <= 20; ++row)
+        {
+            xlnt_assert_equals(ws.has_cell(xlnt::cell_reference(1, row)), row % 2 == 0);
+            xlnt_assert_equals(ws.cell(2, row).value<int>(), static_cast<int>(row) * 10);
+            xlnt_assert_equals(ws.cell(3, row).value<int>(), static_cast<int>(row) * 100);
+        }
+
+        xlnt_assert_equals(ws.calculate_dimension(), "A1:C20");
+    }
 };